@@ -0,0 +1,48 @@
+#pragma once
+#include "LoxCallable.h"
+#include "Nodes.h"
+#include "Object.h"
+#include "Token.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Interpreter;
+
+// A Float64Array: a fixed-length run of doubles stored contiguously,
+// without boxing each element into an Object. Copies of the value
+// share the same storage, as with lists.
+class ArrayObject
+{
+    private:
+        std::shared_ptr<std::vector<double>> data;
+
+    public:
+        ArrayObject();
+        ArrayObject(size_t length);
+        ArrayObject(std::vector<double> elements);
+        Object get(Token name);
+        int size();
+        double* begin();
+        double* end();
+        // Indices must already be checked (and may count from the end).
+        double at(int index);
+        void set(int index, double value);
+        std::string toString(Interpreter& interpreter);
+};
+
+class ArrayFunction final : public LoxCallable
+{
+    private:
+        std::string_view mode;
+        ArrayObject instance;
+
+    public:
+        ArrayFunction() = default;
+        ArrayFunction(std::string_view mode);
+        void bind(ArrayObject& instance);
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
+        int arity() override;
+        std::string toString();
+};
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include "Nodes.h"
+
+// Parsed files kept on disk between runs, one entry per source text.
+// An entry is found by a hash of the text and holds the statements in a
+// compact binary form, with tokens stored as offsets into the text.
+// Resolution is not cached: it depends on the scope a file is run in.
+class AstCache
+{
+    public:
+        static bool enabled;
+        // Parses a file registered in the SourceTable, or loads its
+        // statements from the cache when a valid entry exists.
+        static vpS parse(int file);
+        // Writes the entries parsed since the last call, once the program
+        // has resolved without errors. Entries hold function bodies as
+        // ranges, which are only resolved when first called, so a file
+        // is kept only once its bodies are known to resolve.
+        static void commit();
+};
\ No newline at end of file
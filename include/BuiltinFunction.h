@@ -15,7 +15,7 @@ class BuiltinFunction final : public LoxCallable
     public:
         BuiltinFunction() = default;
         BuiltinFunction(std::string mode);
-        Object call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments) override;
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
         int arity() override;
         std::string toString();
     
@@ -24,7 +24,8 @@ class BuiltinFunction final : public LoxCallable
 
         Object b_clock(); // time_t
         Object b_type(Object object); // std::string
-        Object b_string(Interpreter interpreter, Object object); // std::string
+        Object b_string(Interpreter& interpreter, Object object); // std::string
         Object b_number(Call* expr, Object object); // double
-        Object b_length(Call* expr, Object object); // double
+        Object b_length(Interpreter& interpreter, Call* expr, Object object); // double
+        Object b_float64Array(Call* expr, Object object); // ArrayObject
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "Object.h"
 #include "Token.h"
+#include <functional>
 #include <map>
 #include <string>
 
@@ -15,5 +16,5 @@ class ClassInstance
 	private:
 		// Save the metaclass as an object to avoid circularity.
 		Object klassObj;
-		std::map<std::string, Object> fields;
+		std::map<std::string, Object, std::less<>> fields;
 };
\ No newline at end of file
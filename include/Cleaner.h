@@ -26,13 +26,17 @@ class Cleaner
         void visitBinaryExpr(Binary* &expr);
         void visitCallExpr(Call* &expr);
         void visitCommaExpr(Comma* &expr);
+        void visitDictExpr(Dict* &expr);
         void visitGetExpr(Get* &expr);
         void visitGroupingExpr(Grouping* &expr);
+        void visitIndexExpr(Index* &expr);
         void visitLambdaExpr(Lambda* &expr);
         void visitListExpr(List* &expr);
         void visitLiteralExpr(Literal* &expr);
         void visitLogicalExpr(Logical* &expr);
         void visitSetExpr(Set* &expr);
+        void visitSetIndexExpr(SetIndex* &expr);
+        void visitSliceExpr(Slice* &expr);
         void visitSuperExpr(Super* &expr);
         void visitTernaryExpr(Ternary* &expr);
         void visitThisExpr(This* &expr);
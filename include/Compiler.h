@@ -0,0 +1,76 @@
+#pragma once
+#include "Expr.h"
+#include "Interpreter.h"
+#include "Nodes.h"
+#include "Object.h"
+#include "Stmt.h"
+#include "Token.h"
+#include "Visitor.h"
+#include <functional>
+
+// Turns resolved expressions into closures that the Interpreter runs in
+// their place, each one made for what its node does: reading a local at
+// a known distance, comparing two numbers, adding a constant, and so on.
+// A node is compiled when it is first evaluated, its operands with it.
+// Nodes without a closure of their own run through the Interpreter's
+// visitor methods, which still evaluate their operands compiled.
+class Compiler : public Visitor
+{
+    private:
+        Interpreter* interpreter;
+        Thunk compiled; // What the visited node compiles to.
+
+        Thunk lookUp(Token name, Expr* expr);
+        std::function<Object*()> locate(Token name, Expr* expr);
+        Thunk generic(Expr* expr);
+        template<typename Operation>
+        Thunk numeric(Binary* expr, Operation operation);
+
+    public:
+        static bool enabled;
+
+        Compiler(Interpreter& interpreter);
+        // The closure for the expression, compiled if it isn't yet.
+        Thunk* compile(Expr* expr);
+
+        // Statement methods.
+        // Never called: statements are not compiled.
+
+        void visitBreakStmt(Break* stmt) override;
+        void visitBlockStmt(Block* stmt) override;
+        void visitClassStmt(Class* stmt) override;
+        void visitContinueStmt(Continue* stmt) override;
+        void visitExpressionStmt(Expression* stmt) override;
+        void visitFetchStmt(Fetch* stmt) override;
+        void visitFunctionStmt(Function* stmt) override;
+        void visitIfStmt(If* stmt) override;
+        void visitPrintStmt(Print* stmt) override;
+        void visitReturnStmt(Return* stmt) override;
+        void visitVarStmt(Var* stmt) override;
+        void visitWhileStmt(While* stmt) override;
+
+        // Expression methods.
+        // Return value is always Object(nullptr): the result is left in
+        // compiled instead.
+
+        Object visitAssignExpr(Assign* expr) override;
+        Object visitBinaryExpr(Binary* expr) override;
+        Object visitCallExpr(Call* expr) override;
+        Object visitCommaExpr(Comma* expr) override;
+        Object visitDictExpr(Dict* expr) override;
+        Object visitGetExpr(Get* expr) override;
+        Object visitGroupingExpr(Grouping* expr) override;
+        Object visitIndexExpr(Index* expr) override;
+        Object visitLambdaExpr(Lambda* expr) override;
+        Object visitListExpr(List* expr) override;
+        Object visitLiteralExpr(Literal* expr) override;
+        Object visitLogicalExpr(Logical* expr) override;
+        Object visitSetExpr(Set* expr) override;
+        Object visitSetIndexExpr(SetIndex* expr) override;
+        Object visitSliceExpr(Slice* expr) override;
+        Object visitSuperExpr(Super* expr) override;
+        Object visitTernaryExpr(Ternary* expr) override;
+        Object visitThisExpr(This* expr) override;
+        Object visitUnaryExpr(Unary* expr) override;
+        Object visitVariableExpr(Variable* expr) override;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#include "ListObject.h"
+#include "LoxCallable.h"
+#include "Nodes.h"
+#include "Object.h"
+#include "Token.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Interpreter;
+
+// A SwissTable-style open-addressing table. Slots come in groups of 16,
+// each with one control byte: the low 7 bits of the key's hash for a
+// full slot, or EMPTY/DELETED. A probe compares a whole group of control
+// bytes at once (SSE2 where available) and only looks at the keys whose
+// byte matched. Slots point into a dense entry array, which keeps keys()
+// and values() in insertion order.
+struct DictTable
+{
+    struct Entry
+    {
+        Object key;
+        Object value;
+        size_t hash;
+        bool live;
+    };
+
+    std::vector<int8_t> control;
+    std::vector<int> slots; // Index into entries for each full slot.
+    std::vector<Entry> entries;
+    size_t count = 0;
+    size_t growthLeft = 0; // Free slots left before the 7/8 load limit.
+};
+
+// Like lists, every copy of a dictionary value refers to the same table.
+class DictObject
+{
+    private:
+        std::shared_ptr<DictTable> table;
+
+    public:
+        DictObject();
+        Object get(Token name);
+        int size();
+        // Keys must be hashable (see Hash.h); callers check with checkKey.
+        static void checkKey(Token where, const Object& key);
+        // The stored value, or nullptr when the key is absent.
+        Object* find(const Object& key);
+        void insert(Object key, Object value);
+        bool erase(const Object& key);
+        ListObject keys();
+        ListObject values();
+        std::string toString(Interpreter& interpreter);
+};
+
+class DictFunction final : public LoxCallable
+{
+    private:
+        std::string_view mode;
+        DictObject instance;
+
+    public:
+        DictFunction() = default;
+        DictFunction(std::string_view mode);
+        void bind(DictObject& instance);
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
+        int arity() override;
+        std::string toString();
+};
\ No newline at end of file
@@ -1,24 +1,34 @@
 #pragma once
 #include "Object.h"
 #include "Token.h"
+#include <functional>
 #include <map>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class Environment
 {
     public:
         Environment* enclosing;
-        std::map<std::string, Object> values;
+        std::map<std::string, Object, std::less<>> values;
+        // Environments of the modules fetched into this scope, searched
+        // after its own values.
+        std::vector<Environment*> imports;
 
         Environment();
         Environment(Environment* enclosing);
+        bool contains(std::string_view name);
+        Object* find(std::string_view name);
         Object get(Token name);
         void assign(Token name, Object value);
-        void define(std::string name, Object value, bool access);
+        void define(std::string_view name, Object value, bool access);
         Environment* ancestor(int distance);
         Object getAt(int distance, Token name);
         void assignAt(int distance, Token name, Object value);
 
     private:
-        std::map<std::string, bool> varAccess;
+        std::map<std::string, bool, std::less<>> varAccess;
+
+        Environment* holder(std::string_view name);
 };
\ No newline at end of file
@@ -70,10 +70,5 @@ class ContinueError : public std::exception
 		ContinueError(Token token, std::string loopType);
 };
 
-class ReturnValue : public std::exception
-{
-	public:
-		Object value;
-
-		ReturnValue(Object value);
-};
\ No newline at end of file
+// Stops the run after an error that has already been reported.
+class AbortError : public std::exception {};
\ No newline at end of file
@@ -2,13 +2,20 @@
 #include "Cleaner.h"
 #include "Nodes.h"
 #include "Object.h"
+#include "Quickening.h"
 #include "Token.h"
 #include "Visitor.h"
+#include <functional>
 #include <vector>
 
+// What an expression is compiled to (see Compiler.h).
+using Thunk = std::function<Object()>;
+
 class Expr
 {
     public:
+        Thunk* compiled = nullptr; // Set on first evaluation.
+
         Expr();
         virtual ~Expr();
         virtual Object accept(Visitor& visitor) = 0;
@@ -34,6 +41,10 @@ class Binary : public Expr
         Expr* left;
         Token bOperator;
         Expr* right;
+        // Quickening state for the Interpreter (the Compiler keeps its
+        // own in the closure).
+        Operands seen = UNSEEN;
+        int misses = 0;
 
         Binary(Expr* left, Token bOperator, Expr* right);
         Object accept(Visitor& visitor) override;
@@ -65,6 +76,19 @@ class Comma : public Expr
         bool operator==(Expr& other) override;
 };
 
+class Dict : public Expr
+{
+    public:
+        Token brace;
+        vpE keys;
+        vpE values;
+
+        Dict(Token brace, vpE keys, vpE values);
+        Object accept(Visitor& visitor) override;
+        void remove(Cleaner& cleaner, Expr* &expr) override;
+        bool operator==(Expr& other) override;
+};
+
 class Get : public Expr
 {
     public:
@@ -88,11 +112,25 @@ class Grouping : public Expr
         bool operator==(Expr& other) override;
 };
 
+class Index : public Expr
+{
+    public:
+        Expr* object;
+        Token bracket;
+        Expr* index;
+
+        Index(Expr* object, Token bracket, Expr* index);
+        Object accept(Visitor& visitor) override;
+        void remove(Cleaner& cleaner, Expr* &expr) override;
+        bool operator==(Expr& other) override;
+};
+
 class Lambda : public Expr
 {
     public:
         vT params;
         vpS body;
+        bool makesClosures = false; // As Function::makesClosures.
 
         Lambda(vT params, vpS body);
         Object accept(Visitor& visitor) override;
@@ -148,6 +186,34 @@ class Set : public Expr
         bool operator==(Expr& other) override;
 };
 
+class SetIndex : public Expr
+{
+    public:
+        Expr* object;
+        Token bracket;
+        Expr* index;
+        Expr* value;
+
+        SetIndex(Expr* object, Token bracket, Expr* index, Expr* value);
+        Object accept(Visitor& visitor) override;
+        void remove(Cleaner& cleaner, Expr* &expr) override;
+        bool operator==(Expr& other) override;
+};
+
+class Slice : public Expr
+{
+    public:
+        Expr* object;
+        Token bracket;
+        Expr* start; // Either bound may be nullptr when omitted.
+        Expr* end;
+
+        Slice(Expr* object, Token bracket, Expr* start, Expr* end);
+        Object accept(Visitor& visitor) override;
+        void remove(Cleaner& cleaner, Expr* &expr) override;
+        bool operator==(Expr& other) override;
+};
+
 class Super : public Expr
 {
     public:
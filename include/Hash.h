@@ -0,0 +1,40 @@
+#pragma once
+#include "Object.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hashing of Lox values, consistent with Interpreter::isEqual: numbers,
+// strings, booleans and nil hash by value, instances by identity. Other
+// values (lists, functions, ...) never compare equal, so they are not
+// hashable and are simply never found.
+bool isHashable(const Object& object);
+size_t hashObject(const Object& object);
+bool equalObjects(const Object& a, const Object& b);
+
+// An open-addressing (linear probing) index over a run of list elements,
+// mapping each distinct value to where it first and last occurs.
+// It points into the list's storage, so it must be dropped whenever
+// the list changes.
+class HashIndex
+{
+    public:
+        HashIndex(const Object* elements, int length);
+        // Positions of a value, or -1 when it does not occur.
+        int first(const Object& value);
+        int last(const Object& value);
+
+    private:
+        struct Slot
+        {
+            size_t hash = 0;
+            int first = -1; // -1 marks an empty slot.
+            int last = -1;
+        };
+
+        const Object* elements;
+        std::vector<Slot> slots;
+        size_t mask;
+
+        Slot& probe(const Object& value, size_t hash);
+};
\ No newline at end of file
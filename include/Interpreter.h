@@ -2,6 +2,7 @@
 #include "Cleaner.h"
 #include "Environment.h"
 #include "Expr.h"
+#include "LoxFunction.h"
 #include "Object.h"
 #include "Overloads.h"
 #include "Stmt.h"
@@ -38,15 +39,36 @@ struct distArray
 
 class Interpreter : public Visitor
 {
+    // Builds closures over the private state below.
+    friend class Compiler;
+
     public:
         Environment globals;
         Environment builtins;
+        // Calls nested deeper than maxDepth, or whose native stack would
+        // reach below stackLimit (when set), are a stack overflow.
+        static int maxDepth;
+        static char* stackLimit;
+        // Set by a return statement, with the value returned, until the
+        // call it returns from takes it. The statements on the way out
+        // stop running while it is set.
+        bool returning = false;
+        Object returned;
+        // Set by a return statement whose value is a call, for the call
+        // to see that it is in tail position.
+        bool tailPosition = false;
+        // Set by a call to a Lox function in tail position, in place of
+        // making the call: the function returning makes it instead, so
+        // the stack stays flat.
+        bool tailCalling = false;
+        LoxFunction tailCallee;
+        std::vector<Object> tailArguments;
 
         Interpreter();
         void interpret(vpS);
         void execute(Stmt*);
         Object evaluate(Expr* expr);
-        void executeBlock(vpS statements, Environment& environment);
+        void executeBlock(const vpS& statements, Environment& environment);
         void resolve(Expr* expr, int depth);
 
         // Statement methods.
@@ -70,13 +92,17 @@ class Interpreter : public Visitor
         Object visitBinaryExpr(Binary* expr) override;
         Object visitCallExpr(Call* expr) override;
         Object visitCommaExpr(Comma* expr) override;
+        Object visitDictExpr(Dict* expr) override;
         Object visitGetExpr(Get* expr) override;
         Object visitGroupingExpr(Grouping* expr) override;
+        Object visitIndexExpr(Index* expr) override;
         Object visitLambdaExpr(Lambda* expr) override;
         Object visitListExpr(List* expr) override;
         Object visitLiteralExpr(Literal* expr) override;
         Object visitLogicalExpr(Logical* expr) override;
         Object visitSetExpr(Set* expr) override;
+        Object visitSetIndexExpr(SetIndex* expr) override;
+        Object visitSliceExpr(Slice* expr) override;
         Object visitSuperExpr(Super* expr) override;
         Object visitTernaryExpr(Ternary* expr) override;
         Object visitThisExpr(This* expr) override;
@@ -85,20 +111,29 @@ class Interpreter : public Visitor
 
         // Helper methods.
         std::string stringify(Object object); // Public to use in built-in function string().
+        // Public to let list and sequence methods call back into Lox code.
+        Object invoke(Object callee, std::vector<Object> arguments, Call* expr);
+        bool isCallable(Object object);
+        bool isTruthy(Object object);
+        bool isEqual(Object a, Object b);
+        // Count Lox function calls in and out.
+        void enterCall(Expr* expr);
+        void leaveCall();
 
     private:
         Environment* environment = &globals;
         std::map<Expr*, int> locals;
         int loopLevel = 0;
+        int depth = 0;
         // Cleaner cleaner;
 
         // Helper methods.
         Object lookUpVariable(Token name, Expr *expr);
         void checkNumberOperand(Token bOperator, Object operand);
         void checkNumberOperands(Token bOperator, Object left, Object right);
-        bool isTruthy(Object object);
-        bool isEqual(Object a, Object b);
+        void checkArity(Call* expr, int arity, int count);
         Object plus(Binary* expr, Object left, Object right);
+        int checkIndex(Token bracket, Object index);
 
         template<typename Func>
         Object call(Object callee, std::vector<Object> arguments, Call* expr);
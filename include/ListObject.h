@@ -4,52 +4,77 @@
 #include "Object.h"
 #include "Token.h"
 #include <iostream>
-#include <map>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
+class HashIndex;
 class Interpreter;
 class ListObject;
 class ListFunction;
 
+// The state behind a list value. It is shared by every copy of the value
+// (std::any makes them freely), so all copies refer to the same list.
+// A slice is a view: it shares the buffer of the list it was taken from
+// until one of the two is changed, at which point the changed side takes
+// its own copy of the elements.
+struct ListState
+{
+    std::shared_ptr<std::vector<Object>> buffer;
+    size_t offset = 0;
+    size_t length = 0; // Only used by views.
+    bool view = false;
+    // Built on demand for lookups and dropped on any change.
+    std::shared_ptr<HashIndex> index;
+    int lookups = 0;
+};
+
 class ListObject
 {
     private:
-        std::map<std::string_view, ListFunction> methods;
-    
+        std::shared_ptr<ListState> state;
+
+        HashIndex* buildIndex();
+
     public:
-        std::vector<Object> array;
-        
         ListObject();
         ListObject(std::vector<Object> array);
         Object get(Token name);
-        void set() {}
-        Object& operator[](int index);
+        void set(int index, Object value);
+        int size();
+        // Read-only; negative indices count from the end.
+        const Object& operator[](int index);
+        // The elements for in-place changes (detaches from any slices first).
+        std::vector<Object>& modify();
+        // Position of the first (or last) element equal to value, or -1.
+        int find(Object value, bool last = false);
+        ListObject unique();
         // End is a pointer to allow it to be a nullptr.
         bool checkIndices(int start, int *end);
+        static void checkBounds(int length, int start, int *end);
         ListObject partitionList(int start, int end);
-        std::string toString();
+        std::string toString(Interpreter& interpreter);
 };
 
 class ListFunction final : public LoxCallable
 {
     private:
         std::string_view mode;
-        ListObject *instance;
+        ListObject instance;
+
+        bool check(Call* expr, std::vector<Object> arguments);
 
-        bool check(Call expr, std::vector<Object> arguments);
-    
     public:
         ListFunction() = default;
         ListFunction(std::string_view mode);
         void bind(ListObject& instance);
-        Object call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments) override;
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
 
-        void add(Call expr, Object element);
-        void insert(Call expr, double index, Object element);
-        Object pop(Call expr);
-        Object remove(Call expr, double index);
+        void add(Call* expr, Object element);
+        void insert(Call* expr, double index, Object element);
+        Object pop(Call* expr);
+        Object remove(Call* expr, double index);
 
         int arity() override;
         std::string toString();
@@ -62,10 +87,10 @@ class ListInit : public LoxCallable
         List arrayList(List list);
         List stringList(std::string string);
         List floatList(double size);
-    
+
     public:
         ListInit() = default;
-        Object call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments) override;
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
         int arity() override;
         std::string toString();
 };
\ No newline at end of file
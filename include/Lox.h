@@ -10,14 +10,19 @@ class Lox
 {
 	public:
 		Lox() = default;
-		static void run(std::string& source, std::string fileName = "_REPL_");
+		// Runs a file registered in the SourceTable.
+		static void run(int file);
 		static void runFile(char *path);
 		static void runPrompt();
         static void error(BaseError& exception);
+        // Whether an error has been reported for the current run.
+        static bool failed();
 
 	private:
 		static bool hadError;
 		static bool hadRuntimeError;
+        // Whether run() is given all of the program at once.
+        static bool wholeProgram;
         static Interpreter interpreter;
         static void report(BaseError& error, std::string where);
 		static void prepString(std::string& string);
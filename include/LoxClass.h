@@ -4,8 +4,10 @@
 #include "LoxCallable.h"
 #include "LoxFunction.h"
 #include "Object.h"
+#include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class LoxClass final : public LoxCallable, public ClassInstance
@@ -13,14 +15,17 @@ class LoxClass final : public LoxCallable, public ClassInstance
     public:
         std::string name;
         LoxClass* superclass;
-        std::map<std::string, LoxFunction> methods;
+        // Made once per class declaration, so it tells classes apart
+        // across copies.
+        LoxClass* metaclass = nullptr;
+        std::map<std::string, LoxFunction, std::less<>> methods;
 
         LoxClass() = default;
         LoxClass(std::string name, LoxClass* metaclass,
-                LoxClass* superclass, std::map<std::string, LoxFunction> methods);
-        bool hasMethod(std::string name);
-        LoxFunction findMethod(std::string name);
+                LoxClass* superclass, std::map<std::string, LoxFunction, std::less<>> methods);
+        bool hasMethod(std::string_view name);
+        LoxFunction findMethod(std::string_view name);
         std::string toString();
-        Object call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments) override;
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
         int arity() override;
 };
\ No newline at end of file
@@ -21,7 +21,8 @@ class LoxFunction final : public LoxCallable//<LoxFunction>
         ~LoxFunction() = default;
         LoxFunction bind(LoxInstance* instance);
         LoxFunction bind(ClassInstance* instance);
-        Object call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments);
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments);
+        bool sameAs(LoxFunction& other);
         bool isGetter();
         int arity();
         std::string toString();
@@ -29,4 +30,6 @@ class LoxFunction final : public LoxCallable//<LoxFunction>
     private:
         Environment closure;
         bool isInitializer;
+
+        Object run(Interpreter& interpreter, std::vector<Object>& arguments);
 };
\ No newline at end of file
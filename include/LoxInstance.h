@@ -3,6 +3,7 @@
 #include "LoxClass.h"
 #include "Object.h"
 #include "Token.h"
+#include <functional>
 #include <map>
 #include <string>
 
@@ -16,5 +17,5 @@ class LoxInstance
     
     private:
         LoxClass klass;
-        std::map<std::string, Object> fields;
+        std::map<std::string, Object, std::less<>> fields;
 };
\ No newline at end of file
@@ -8,13 +8,17 @@ class Assign;
 class Binary;
 class Call; 
 class Comma; 
+class Dict;
 class Get;
 class Grouping;
+class Index;
 class Lambda;
 class List;
 class Literal;
 class Logical;
 class Set; 
+class SetIndex;
+class Slice;
 class Super; 
 class Ternary; 
 class This; 
@@ -34,6 +38,8 @@ class Print;
 class Return;
 class Var;
 class While;
+struct LazyBody;
+struct Module;
 
 using vT = std::vector<Token>;
 
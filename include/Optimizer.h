@@ -0,0 +1,102 @@
+#pragma once
+#include "Expr.h"
+#include "Interpreter.h"
+#include "Nodes.h"
+#include "Object.h"
+#include "Pruner.h"
+#include "Stmt.h"
+#include "Visitor.h"
+#include <map>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <vector>
+
+// Simplifies resolved statements before they are run: folds operations
+// on literals, replaces reads of fixed variables that hold a literal,
+// inlines calls to small global functions, drops if-branches that can't
+// be taken and statements after a return, break or continue. Anything
+// that would raise a runtime error is left as it is, so the error still
+// happens when (and if) it is reached.
+class Optimizer : public Visitor
+{
+    private:
+        Interpreter* interpreter;
+        // Names declared in each local scope so far, with the value of
+        // those that are constants.
+        std::vector<std::map<std::string_view, std::optional<Object>>> scopes;
+        // Global constants, from fixed variables declared exactly once
+        // in the whole program, directly in the script.
+        std::map<std::string_view, Object> globals;
+        std::set<Stmt*> globalConstants;
+        // Global functions whose calls may be replaced by their body: declared
+        // once, directly in the script, and never rebound.
+        std::map<std::string_view, Function*> inlinable;
+        std::set<Stmt*> globalFunctions;
+        // What the visited node becomes, when it is replaced. A statement
+        // may become nullptr: it is removed.
+        Expr* expression = nullptr;
+        Stmt* statement = nullptr;
+        bool replaced = false;
+
+        void findGlobals(const vpS& script, const Pruner& program);
+        void declare(std::string_view name, std::optional<Object> value = std::nullopt);
+        bool isLocal(std::string_view name);
+        void predeclare(Stmt* stmt, std::set<Module*>& seen);
+        void optimizeBody(Function* function);
+        void optimizeList(vpS& statements, bool trim);
+        Stmt* optimize(Stmt* stmt);
+        Expr* optimize(Expr* expr);
+        Expr* fold(Expr* expr);
+        Expr* inlineBody(Function* function);
+        Expr* substitute(Expr* body, const vT& params, const vpE& arguments);
+
+    public:
+        static bool enabled;
+
+        Optimizer(Interpreter& interpreter);
+        // Optimizes the statements of one run, in place. Globals are only
+        // relied on when the run is all of the program: the Pruner has
+        // been through it then, and is passed in.
+        void optimize(vpS& statements, const Pruner* program);
+
+        // Statement methods.
+
+        void visitBreakStmt(Break* stmt) override;
+        void visitBlockStmt(Block* stmt) override;
+        void visitClassStmt(Class* stmt) override;
+        void visitContinueStmt(Continue* stmt) override;
+        void visitExpressionStmt(Expression* stmt) override;
+        void visitFetchStmt(Fetch* stmt) override;
+        void visitFunctionStmt(Function* stmt) override;
+        void visitIfStmt(If* stmt) override;
+        void visitPrintStmt(Print* stmt) override;
+        void visitReturnStmt(Return* stmt) override;
+        void visitVarStmt(Var* stmt) override;
+        void visitWhileStmt(While* stmt) override;
+
+        // Expression methods.
+        // Return value is always Object(nullptr): the result is left in
+        // expression instead.
+
+        Object visitAssignExpr(Assign* expr) override;
+        Object visitBinaryExpr(Binary* expr) override;
+        Object visitCallExpr(Call* expr) override;
+        Object visitCommaExpr(Comma* expr) override;
+        Object visitDictExpr(Dict* expr) override;
+        Object visitGetExpr(Get* expr) override;
+        Object visitGroupingExpr(Grouping* expr) override;
+        Object visitIndexExpr(Index* expr) override;
+        Object visitLambdaExpr(Lambda* expr) override;
+        Object visitListExpr(List* expr) override;
+        Object visitLiteralExpr(Literal* expr) override;
+        Object visitLogicalExpr(Logical* expr) override;
+        Object visitSetExpr(Set* expr) override;
+        Object visitSetIndexExpr(SetIndex* expr) override;
+        Object visitSliceExpr(Slice* expr) override;
+        Object visitSuperExpr(Super* expr) override;
+        Object visitTernaryExpr(Ternary* expr) override;
+        Object visitThisExpr(This* expr) override;
+        Object visitUnaryExpr(Unary* expr) override;
+        Object visitVariableExpr(Variable* expr) override;
+};
\ No newline at end of file
@@ -1,21 +1,44 @@
 #pragma once
 #include "Nodes.h"
+#include "Scanner.h"
 #include "Token.h"
 #include "TokenType.h"
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Parser
 {
     public:
-        Parser(vT tokens);
+        // Parses a file registered in the SourceTable, pulling tokens
+        // from the scanner as it goes.
+        Parser(int file);
         vpS parse();
+        // Finds and parses the file of a GetLib or GetFile, once per
+        // process. Returns null if there is no such file.
+        static Module* import(const std::string& mode, const std::string& name);
+        // Parses and resolves a function body loaded from the AstCache as
+        // a range, on its first call. Errors are reported, then
+        // AbortError ends the run.
+        static void compile(LazyBody& lazy);
+        // The same, ahead of the first call, returning false instead of
+        // reporting a syntax error. Resolving the body prints nothing
+        // new: bodies are checked when their file is parsed, and the
+        // AstCache only keeps files that resolved without errors.
+        static bool precompile(LazyBody& lazy);
+        // Warnings printed so far, by any parser.
+        static int warnings;
     
     private:
-        vT tokens;
-        int current = 0;
+        int file;
+        Scanner scanner;
+        Token currentToken;
+        Token previousToken;
         std::string loopType;
 
+        Parser(const LazyBody& lazy);
+
         // Statement methods.
 
         Stmt* declaration();
@@ -36,33 +59,50 @@ class Parser
 
         // Expression methods.
 
-        Expr* expression();
-        Expr* comma();
+        // Binding levels, loosest first.
+        enum class Precedence
+        {
+            COMMA, LAMBDA, ASSIGNMENT, OR, AND, TERNARY, EQUALITY,
+            COMPARISON, TERM, FACTOR, UNARY, EXPONENT, CALL, PRIMARY
+        };
+
+        struct Rule
+        {
+            // Parses an expression starting with the token just consumed.
+            Expr* (Parser::*prefix)() = nullptr;
+            Precedence prefixPrecedence = Precedence::PRIMARY;
+            // Parses the rest of an expression the token continues.
+            Expr* (Parser::*infix)(Expr* left) = nullptr;
+            Precedence precedence = Precedence::COMMA;
+            Precedence operand = Precedence::COMMA; // Level of the right side.
+        };
+
+        static const std::array<Rule, RIGHT_BRACKET + 1> rules;
+
+        Expr* expression(Precedence precedence = Precedence::COMMA);
         Expr* lambda();
-        Expr* assignment();
-        Expr* orExpr();
-        Expr* andExpr();
-        Expr* ternary();
-        Expr* equality();
-        Expr* comparison();
-        Expr* term();
-        Expr* factor();
         Expr* unary();
-        Expr* exponent();
-        Expr* finishCall(Expr* callee);
-        Expr* call();
-        Expr* list();
         Expr* primary();
+        Expr* list();
+        Expr* dict();
+        Expr* comma(Expr* left);
+        Expr* assignment(Expr* target);
+        Expr* logical(Expr* left);
+        Expr* ternary(Expr* condition);
+        Expr* binary(Expr* left);
+        Expr* finishCall(Expr* callee);
+        Expr* property(Expr* object);
+        Expr* finishSubscript(Expr* object);
 
         // Helper methods.
 
         template<typename... Type>
         bool match(Type... types);
-        Token consume(TokenType type, std::string message);
+        // Returned references stay valid until the next advance().
+        const Token& consume(TokenType type, std::string_view message);
         bool check(TokenType type);
-        Token advance();
+        const Token& advance();
         bool isAtEnd();
-        Token peek();
-        Token previous();
-        void synchronize();
+        const Token& peek();
+        const Token& previous();
 };
\ No newline at end of file
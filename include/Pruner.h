@@ -0,0 +1,97 @@
+#pragma once
+#include "Expr.h"
+#include "Nodes.h"
+#include "Stmt.h"
+#include "Visitor.h"
+#include <deque>
+#include <map>
+#include <set>
+#include <string_view>
+#include <vector>
+
+// Drops the top-level functions and classes of a script, and of the files
+// it imports, that nothing can ever reach. Run after the Resolver on a
+// whole program only, as a later REPL line could still refer to them.
+// Reachability is by name: any identifier in code that is kept keeps
+// every declaration of that name, which errs on the side of keeping.
+class Pruner : public Visitor
+{
+    private:
+        // A top-level declaration that may be dropped.
+        struct Candidate
+        {
+            Stmt* stmt;
+            std::string_view name;
+            std::string_view superclass; // Empty when there is none.
+            bool afterSuperclass; // A class of that name comes first.
+            bool kept = false;
+        };
+
+        std::deque<Candidate> declarations;
+        std::map<std::string_view, std::vector<Candidate*>> candidates;
+        std::set<std::string_view> used;
+        std::set<std::string_view> rebound; // Targets of '=' or 'var'.
+        std::vector<Candidate*> pending; // Used, but not yet walked.
+        std::vector<vpS*> lists; // Top-level lists, swept at the end.
+        std::set<Module*> modules;
+        bool importsUnparsed = false;
+
+        void topLevel(vpS& statements);
+        void use(std::string_view name);
+        void keep(Candidate* candidate);
+        void walk(const vpS& statements);
+        void walk(Stmt* stmt);
+        void walk(Expr* expr);
+        void walkDeclaration(Stmt* stmt);
+        void walkBody(Function* function);
+        void scanBody(const LazyBody& lazy);
+        bool droppable(Candidate* candidate);
+        void discard(Stmt* stmt);
+
+    public:
+        void prune(vpS& statements);
+        // What the kept code was found to do, once pruned: the names it
+        // may declare or assign anywhere but at the top level, and
+        // whether a function body imports files not parsed yet.
+        bool rebinds(std::string_view name) const;
+        bool importsLater() const;
+
+        // Statement methods.
+
+        void visitBreakStmt(Break* stmt) override;
+        void visitBlockStmt(Block* stmt) override;
+        void visitClassStmt(Class* stmt) override;
+        void visitContinueStmt(Continue* stmt) override;
+        void visitExpressionStmt(Expression* stmt) override;
+        void visitFetchStmt(Fetch* stmt) override;
+        void visitFunctionStmt(Function* stmt) override;
+        void visitIfStmt(If* stmt) override;
+        void visitPrintStmt(Print* stmt) override;
+        void visitReturnStmt(Return* stmt) override;
+        void visitVarStmt(Var* stmt) override;
+        void visitWhileStmt(While* stmt) override;
+
+        // Expression methods.
+        // Return value is always Object(nullptr).
+
+        Object visitAssignExpr(Assign* expr) override;
+        Object visitBinaryExpr(Binary* expr) override;
+        Object visitCallExpr(Call* expr) override;
+        Object visitCommaExpr(Comma* expr) override;
+        Object visitDictExpr(Dict* expr) override;
+        Object visitGetExpr(Get* expr) override;
+        Object visitGroupingExpr(Grouping* expr) override;
+        Object visitIndexExpr(Index* expr) override;
+        Object visitLambdaExpr(Lambda* expr) override;
+        Object visitListExpr(List* expr) override;
+        Object visitLiteralExpr(Literal* expr) override;
+        Object visitLogicalExpr(Logical* expr) override;
+        Object visitSetExpr(Set* expr) override;
+        Object visitSetIndexExpr(SetIndex* expr) override;
+        Object visitSliceExpr(Slice* expr) override;
+        Object visitSuperExpr(Super* expr) override;
+        Object visitTernaryExpr(Ternary* expr) override;
+        Object visitThisExpr(This* expr) override;
+        Object visitUnaryExpr(Unary* expr) override;
+        Object visitVariableExpr(Variable* expr) override;
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "Object.h"
+#include <any>
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// Operand checks that don't copy the value, for the Compiler's closures
+// and the Interpreter's visitor methods alike.
+
+// Same as Interpreter::isTruthy, without copying the value.
+inline bool truthy(const Object& object)
+{
+    const std::type_info& type = object.value.type();
+    if (type == typeid(bool)) return std::any_cast<bool>(object.value);
+    return (type != typeid(std::nullptr_t)) && (type != typeid(std::vector<int>));
+}
+
+inline bool isNumber(const Object& object)
+{
+    return object.value.type() == typeid(double);
+}
+
+inline double number(const Object& object)
+{
+    return *std::any_cast<double>(&object.value);
+}
+
+inline bool isString(const Object& object)
+{
+    return object.value.type() == typeid(std::string);
+}
+
+inline const std::string& text(const Object& object)
+{
+    return *std::any_cast<std::string>(&object.value);
+}
+
+// Quickening: a node whose operands can be of several types keeps the
+// case it has seen so far, and runs that case directly while it holds.
+// When it doesn't, the node runs the general code and picks its case
+// again from what it got, until it has missed too often. Operators that
+// take one type only, like '-' or '<' on numbers, have a single case:
+// their guard is all there is to it.
+enum Operands
+{
+    UNSEEN,
+    NUMBERS,
+    STRINGS,
+    MIXED // Missed too often: stays general.
+};
+
+const int maxMisses = 8;
+
+inline Operands operands(const Object& a, const Object& b)
+{
+    if (isNumber(a) && isNumber(b)) return NUMBERS;
+    if (isString(a) && isString(b)) return STRINGS;
+    return UNSEEN;
+}
+
+// After a miss on a and b: picks the case again, or gives up.
+inline void requicken(Operands& seen, int& misses, const Object& a, const Object& b)
+{
+    if (seen != MIXED)
+        seen = (++misses > maxMisses) ? MIXED : operands(a, b);
+}
@@ -5,6 +5,7 @@
 #include "Stmt.h"
 #include "Token.h"
 #include "Visitor.h"
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -13,11 +14,14 @@ class Resolver : public Visitor
 {
     private:
         Interpreter* interpreter;
-        std::vector<std::map<std::string, int>> scopes;
+        std::vector<std::map<std::string, int, std::less<>>> scopes;
         enum FunctionType { NOFUNC, FUNCTION, LAMBDA, INITIALIZER, METHOD };
         enum ClassType { NOCLASS, CLASS, SUBCLASS };
         FunctionType currentFunction = NOFUNC;
         ClassType currentClass = NOCLASS;
+        // The makesClosures flags of the function being resolved and of
+        // its blocks around the current statement.
+        std::vector<bool*> capturing;
     
     public:
         Resolver(Interpreter& interpreter);
@@ -34,6 +38,7 @@ class Resolver : public Visitor
         void resolveLocal(Expr* expr, Token name);
         void resolveFunction(Function* function, FunctionType type);
         void resolveLambda(Lambda* lambda, FunctionType type);
+        void makeClosure();
 
         // Statement methods.
 
@@ -58,13 +63,17 @@ class Resolver : public Visitor
         Object visitBinaryExpr(Binary* expr) override;
         Object visitCallExpr(Call* expr) override;
         Object visitCommaExpr(Comma* expr) override;
+        Object visitDictExpr(Dict* expr) override;
         Object visitGetExpr(Get* expr) override;
         Object visitGroupingExpr(Grouping* expr) override;
+        Object visitIndexExpr(Index* expr) override;
         Object visitLambdaExpr(Lambda* expr) override;
         Object visitListExpr(List* expr) override;
         Object visitLiteralExpr(Literal* expr) override;
         Object visitLogicalExpr(Logical* expr) override;
         Object visitSetExpr(Set* expr) override;
+        Object visitSetIndexExpr(SetIndex* expr) override;
+        Object visitSliceExpr(Slice* expr) override;
         Object visitSuperExpr(Super* expr) override;
         Object visitTernaryExpr(Ternary* expr) override;
         Object visitThisExpr(This* expr) override;
@@ -1,26 +1,59 @@
 #pragma once
+#include "Error.h"
 #include "Object.h"
 #include "Token.h"
 #include "TokenType.h"
-#include <map>
+#include <deque>
+#include <future>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Scanner
 {
 	public:
-		Scanner(std::string& source, std::string& fileName);
+		// Scans a file registered in the SourceTable.
+		Scanner(int file);
 		std::vector<Token> scanTokens();
+		// A scanner for the part of the file from begin up to end. The
+		// character before begin is at the given line and column.
+		Scanner(int file, size_t begin, size_t end, unsigned int line,
+		        unsigned int column = 0);
+		// Hands out one token at a time, scanning only as far as needed.
+		// Keeps returning the EOF token once the source is used up.
+		Token next();
 
 	private:
-		std::string source;
+		struct Cut
+		{
+			size_t offset;     // Just after a newline.
+			unsigned int line; // The line that starts there.
+		};
+
+		std::string_view source;
+        int file;
         std::string fileName;
 		std::vector<Token> tokens;
+        size_t served = 0; // Tokens already handed out by next().
+        bool started = false;
+        // Reported once scanning is done, in source order.
+        std::vector<ScanError> errors;
+        // Where a big source is split for next(), and the pieces being
+        // scanned ahead of the parser on other threads, in order.
+        std::vector<Cut> cuts;
+        size_t nextCut = 0;
+        std::deque<std::future<Scanner>> ahead;
 		unsigned int start = 0;
 		unsigned int current = 0;
-        unsigned int column = 0;
+        unsigned int column = 0; // Column of the last character consumed.
+        unsigned int startColumn = 0;
 		unsigned int line = 1;
-		std::map<std::string, TokenType> keywords;
+
+		static std::vector<Cut> findCuts(std::string_view text, unsigned int parts);
+		unsigned int parallelParts();
+		void scanRange();
+		void scanParallel(unsigned int parts);
+		bool scanAhead(std::vector<Token> buffer = {});
 
 		bool match(char expected);
 		char peek();
@@ -28,10 +61,10 @@ class Scanner
 		bool isAtEnd();
 		char advance();
 		void addToken(TokenType type);
-		void addToken(TokenType type, Object literal);
 
 		void scanToken();
 		void identifier();
 		void number();
+		void digits(bool (*isDigit)(char));
 		void string();
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include "ListObject.h"
+#include "LoxCallable.h"
+#include "Nodes.h"
+#include "Object.h"
+#include "Token.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Interpreter;
+
+// A lazy view over a list produced by transform/filter/pair/flat.
+// Stages are only recorded; the whole chain runs as one fused pass
+// over the source when a terminal method (or printing) needs values.
+class SequenceObject
+{
+    public:
+        enum StageKind { TRANSFORM, FILTER, PAIR, FLAT };
+
+        struct Stage
+        {
+            StageKind kind;
+            Object argument; // Callback for TRANSFORM/FILTER, list for PAIR.
+            Call* site;      // Where the stage was added, for error reports.
+        };
+
+        SequenceObject() = default;
+        SequenceObject(ListObject source);
+        SequenceObject extend(StageKind kind, Object argument, Call* site);
+        Object get(Token name);
+        // Runs every source element through the stages and hands the results
+        // to sink in order. The sink returns false to stop the pass early.
+        void run(Interpreter& interpreter, const std::function<bool(Object)>& sink);
+        ListObject collect(Interpreter& interpreter);
+        std::string toString(Interpreter& interpreter);
+
+        // Shared by list and sequence methods.
+        static bool hasMethod(std::string_view mode);
+        static int arity(std::string_view mode);
+        Object apply(std::string_view mode, Interpreter& interpreter, Call* expr,
+                     std::vector<Object> arguments);
+
+    private:
+        ListObject source;
+        std::vector<Stage> stages;
+
+        bool push(Interpreter& interpreter, size_t stage, Object value,
+                  std::vector<size_t>& positions, const std::function<bool(Object)>& sink);
+        Object reduce(std::string_view mode, Interpreter& interpreter, Call* expr);
+};
+
+class SequenceFunction final : public LoxCallable
+{
+    private:
+        std::string_view mode;
+        SequenceObject instance;
+
+    public:
+        SequenceFunction() = default;
+        SequenceFunction(std::string_view mode, SequenceObject instance);
+        Object call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments) override;
+        int arity() override;
+        std::string toString();
+};
\ No newline at end of file
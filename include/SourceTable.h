@@ -0,0 +1,39 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <string_view>
+
+// Every source text the interpreter has loaded: the script, its imports
+// and each REPL entry. Tokens refer into these buffers by file ID, so a
+// buffer is kept (and never moved) for the rest of the run.
+// ID 0 is reserved for tokens made up by the interpreter itself.
+class SourceTable
+{
+    public:
+        // Takes ownership of the text and returns its file ID.
+        static int add(std::string name, std::string text);
+        // Maps a large file read-only while it is compiled; reads smaller
+        // files, and pipes, in one go. Returns -1 if it cannot be opened.
+        static int load(std::string path);
+        // Called once the file is compiled: its mapped pages are swapped
+        // for a private copy at the same address, so tokens stay valid
+        // however the file changes on disk afterwards.
+        static void seal(int file);
+        static std::string_view text(int file);
+        static const std::string& name(int file);
+
+    private:
+        struct File
+        {
+            std::string name;
+            std::string storage; // Empty when the text is mapped.
+            std::string_view text;
+            bool mapped = false; // Still backed by the file itself.
+        };
+
+        // Smaller files are read: mapping them saves next to nothing.
+        static const size_t mapMinimum = 1 << 20;
+
+        // A deque keeps earlier entries in place as it grows.
+        static std::deque<File> files;
+};
\ No newline at end of file
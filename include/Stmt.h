@@ -3,9 +3,12 @@
 #include "Nodes.h"
 #include "Token.h"
 #include "Visitor.h"
+#include <functional>
 #include <string>
 #include <vector>
 
+class Environment;
+
 class Stmt
 {
     public:
@@ -34,6 +37,7 @@ class Block : public Stmt
 {
     public:
         vpS statements;
+        bool makesClosures = false; // Set by the Resolver.
 
         Block(vpS statements);
         void accept(Visitor& visitor) override;
@@ -67,24 +71,66 @@ class Continue : public Stmt
         bool operator==(Stmt& other) override;
 };
 
+// A file brought in by GetLib or GetFile. It is parsed once and shared
+// by every Fetch of it. The first Fetch to run it runs it in an
+// environment of its own; every Fetch then binds that environment into
+// its scope, so the file's definitions are seen there.
+struct Module
+{
+    vpS statements;
+    std::vector<std::string> names; // Declared at its top, once resolved.
+    Environment* environment = nullptr; // Once it has run.
+    bool resolved = false;
+    bool optimized = false;
+    bool executed = false;
+};
+
 class Fetch : public Stmt
 {
     public:
         std::string mode;
         std::string name;
+        Module* module; // Null for GetMod.
 
-        Fetch(std::string mode, std::string name);
+        Fetch(std::string mode, std::string name, Module* module = nullptr);
         void accept(Visitor& visitor) override;
         void remove(Cleaner& cleaner, Stmt*& stmt) override;
         bool operator==(Stmt& other) override;
 };
 
+// Where a named function's body is in its file, so the AstCache can
+// store the body as a range. A body parsed with its file is compiled
+// from the start, and resolved and optimized with it. A body loaded
+// from the AstCache is parsed and resolved the first time the function
+// is called; see Parser::compile.
+struct LazyBody
+{
+    int file;
+    unsigned int begin; // Just after the '{'.
+    unsigned int end;   // Just past the matching '}'.
+    int line;           // Of the '{'.
+    int column;
+    std::string loopType;
+    // Set by the Resolver: resolves the body within the scopes that
+    // surrounded the declaration.
+    std::function<void(vpS&)> resolve;
+    // Set by the Optimizer, when it runs: the same, for optimizing.
+    std::function<void(vpS&)> optimize;
+    bool compiled = false; // statements hold the body.
+    bool makesClosures = false; // As Function::makesClosures.
+    vpS statements;
+};
+
 class Function : public Stmt, public Declaration
 {
     public:
         Token name;
         vT* params;
         vpS body;
+        LazyBody* lazy = nullptr; // Body is in here instead when set.
+        // Set by the Resolver when the body declares a function, lambda
+        // or class, which may outlive the call's environment.
+        bool makesClosures = false;
 
         Function() = default;
         Function(Token name, vT* params, vpS body);
@@ -2,20 +2,25 @@
 #include "Object.h"
 #include "TokenType.h"
 #include <string>
+#include <string_view>
 
+// Tokens are plain records: the lexeme is a view into the source buffer
+// held by SourceTable, and literals are decoded from it on demand.
 class Token
 {
 	public:
 		TokenType type;
-		std::string lexeme;
-		Object literal;
+		std::string_view lexeme;
 		int line;
         int column;
-        std::string fileName;
+        int file; // SourceTable ID.
 
-		Token() : line(0) {};
-		Token(TokenType type, std::string lexeme, Object literal, int line,
-              int column, std::string fileName);
+		Token() : line(0), column(0), file(0) {};
+		Token(TokenType type, std::string_view lexeme, int line, int column,
+              int file = 0);
         bool operator==(Token& other);
-		std::string toString();
+        // The value of a NUMBER or STRING token (nil for anything else).
+        Object literal() const;
+        const std::string& fileName() const;
+		std::string toString() const;
 };
\ No newline at end of file
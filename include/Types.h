@@ -15,6 +15,12 @@ enum Type {
     CLASS_INST,
     LIST,
 	LIST_FUNC,
+    SEQ,
+    SEQ_FUNC,
+    DICT,
+    DICT_FUNC,
+    ARRAY,
+    ARRAY_FUNC,
     TIME,
 	NONE,
 	INVALID
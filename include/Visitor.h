@@ -22,13 +22,17 @@ class Visitor
         virtual Object visitBinaryExpr(Binary* expr) = 0;
         virtual Object visitCallExpr(Call* expr) = 0;
         virtual Object visitCommaExpr(Comma* expr) = 0;
+        virtual Object visitDictExpr(Dict* expr) = 0;
         virtual Object visitGetExpr(Get* expr) = 0;
         virtual Object visitGroupingExpr(Grouping* expr) = 0;
+        virtual Object visitIndexExpr(Index* expr) = 0;
         virtual Object visitLambdaExpr(Lambda* expr) = 0;
         virtual Object visitListExpr(List* expr) = 0;
         virtual Object visitLiteralExpr(Literal* expr) = 0;
         virtual Object visitLogicalExpr(Logical* expr) = 0;
         virtual Object visitSetExpr(Set* expr) = 0;
+        virtual Object visitSetIndexExpr(SetIndex* expr) = 0;
+        virtual Object visitSliceExpr(Slice* expr) = 0;
         virtual Object visitSuperExpr(Super* expr) = 0;
         virtual Object visitTernaryExpr(Ternary* expr) = 0;
         virtual Object visitThisExpr(This* expr) = 0;
@@ -0,0 +1,170 @@
+#include "../include/ArrayObject.h"
+#include "../include/Error.h"
+#include "../include/Expr.h"
+#include "../include/Interpreter.h"
+#include "../include/ListObject.h"
+#include "../include/Object.h"
+#include "../include/Token.h"
+#include "../include/Types.h"
+#include <algorithm>
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define double(obj) std::any_cast<double>(obj.value)
+
+static std::string_view functions[] = {
+    "fill", "copy", "list", "sum", "min", "max", "average"
+};
+
+static double sum(ArrayObject& array)
+{
+    // Independent partial sums let the additions overlap.
+    double partial[4] = {0, 0, 0, 0};
+    double* element = array.begin();
+    for (; element + 4 <= array.end(); element += 4)
+    {
+        partial[0] += element[0];
+        partial[1] += element[1];
+        partial[2] += element[2];
+        partial[3] += element[3];
+    }
+
+    double total = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+    for (; element != array.end(); element++)
+        total += *element;
+    return total;
+}
+
+// class ArrayObject
+
+ArrayObject::ArrayObject()
+{
+    this->data = std::make_shared<std::vector<double>>();
+}
+
+ArrayObject::ArrayObject(size_t length)
+{
+    this->data = std::make_shared<std::vector<double>>(length, 0.0);
+}
+
+ArrayObject::ArrayObject(std::vector<double> elements)
+{
+    this->data = std::make_shared<std::vector<double>>(std::move(elements));
+}
+
+Object ArrayObject::get(Token name)
+{
+    for (std::string_view function : functions)
+    {
+        if (function == name.lexeme)
+        {
+            ArrayFunction method(function);
+            method.bind(*this);
+            return Object(method);
+        }
+    }
+
+    throw RuntimeError(name, "Undefined property or method '" + std::string(name.lexeme) + "'.");
+}
+
+int ArrayObject::size()
+{
+    return (int) data->size();
+}
+
+double* ArrayObject::begin()
+{
+    return data->data();
+}
+
+double* ArrayObject::end()
+{
+    return data->data() + data->size();
+}
+
+double ArrayObject::at(int index)
+{
+    if (index < 0) index += size();
+    return (*data)[index];
+}
+
+void ArrayObject::set(int index, double value)
+{
+    if (index < 0) index += size();
+    (*data)[index] = value;
+}
+
+std::string ArrayObject::toString(Interpreter& interpreter)
+{
+    std::string string = "Float64Array[";
+
+    for (int i = 0; i < size(); i++)
+    {
+        if (i != 0) string += ", ";
+        string += interpreter.stringify(Object((*data)[i]));
+    }
+
+    string += "]";
+    return string;
+}
+
+// class ArrayFunction
+
+ArrayFunction::ArrayFunction(std::string_view mode)
+{
+    this->mode = mode;
+}
+
+void ArrayFunction::bind(ArrayObject& instance)
+{
+    this->instance = instance;
+}
+
+Object ArrayFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
+{
+    (void) interpreter;
+    Call* call = (Call *) expr;
+
+    if (mode == "fill")
+    {
+        if (type(arguments[0]) != NUM)
+            throw RuntimeError(call->paren, "Float64Array elements must be numbers.");
+        std::fill(instance.begin(), instance.end(), double(arguments[0]));
+        return Object(nullptr);
+    }
+    if (mode == "copy")
+        return Object(ArrayObject(std::vector<double>(instance.begin(), instance.end())));
+    if (mode == "list")
+    {
+        std::vector<Object> elements;
+        elements.reserve(instance.size());
+        for (double* element = instance.begin(); element != instance.end(); element++)
+            elements.push_back(Object(*element));
+        return Object(ListObject(std::move(elements)));
+    }
+
+    if (mode == "sum")
+        return Object(sum(instance));
+    // The rest have no value for an empty array.
+    if (instance.size() == 0) return Object(nullptr);
+    if (mode == "min")
+        return Object(*std::min_element(instance.begin(), instance.end()));
+    if (mode == "max")
+        return Object(*std::max_element(instance.begin(), instance.end()));
+    if (mode == "average")
+        return Object(sum(instance) / instance.size());
+    return Object(nullptr); // Unreachable.
+}
+
+int ArrayFunction::arity()
+{
+    if (mode == "fill") return 1;
+    return 0;
+}
+
+std::string ArrayFunction::toString()
+{
+    return "<Float64Array method " + std::string(mode) + ">";
+}
\ No newline at end of file
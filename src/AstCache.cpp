@@ -0,0 +1,919 @@
+#include "../include/AstCache.h"
+#include "../include/Expr.h"
+#include "../include/Lox.h"
+#include "../include/Object.h"
+#include "../include/Parser.h"
+#include "../include/SourceTable.h"
+#include "../include/Stmt.h"
+#include "../include/Token.h"
+#include "../include/Types.h"
+#include "../include/Visitor.h"
+#include <any>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+bool AstCache::enabled = true;
+
+// Bump whenever the layout of the nodes or of this format changes.
+static const uint32_t FORMAT_VERSION = 2;
+static const char MAGIC[4] = {'L', 'O', 'X', 'C'};
+
+enum Tag : uint8_t
+{
+    NO_NODE,
+
+    BREAK_STMT, BLOCK_STMT, CLASS_STMT, CONTINUE_STMT, FETCH_STMT,
+    FUNCTION_STMT, IF_STMT, EXPRESSION_STMT, PRINT_STMT, RETURN_STMT,
+    VAR_STMT, WHILE_STMT,
+
+    ASSIGN_EXPR, BINARY_EXPR, CALL_EXPR, COMMA_EXPR, DICT_EXPR, GET_EXPR,
+    GROUPING_EXPR, INDEX_EXPR, LAMBDA_EXPR, LIST_EXPR, LITERAL_EXPR,
+    LOGICAL_EXPR, SET_EXPR, SET_INDEX_EXPR, SLICE_EXPR, SUPER_EXPR,
+    TERNARY_EXPR, THIS_EXPR, UNARY_EXPR, VARIABLE_EXPR
+};
+
+// How a token's lexeme is stored.
+enum Lexeme : uint8_t
+{
+    IN_SOURCE,   // Offset and length into the file's text.
+    OWN_FILE,    // Spelled out, but the token belongs to the file.
+    MADE_UP      // Spelled out, for tokens with file ID 0.
+};
+
+// Thrown for any entry that cannot be written or read back; the file is
+// then simply parsed.
+struct BadEntry {};
+
+// Made-up lexemes read from entries, kept for the rest of the run.
+static std::deque<std::string> lexemes;
+
+// Two independent 64-bit hashes of the text: the first names the entry,
+// the second is checked along with the length.
+struct Key
+{
+    uint64_t name;
+    uint64_t check;
+    uint64_t length;
+};
+
+static uint64_t mix(uint64_t hash)
+{
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111eb;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+static Key keyOf(std::string_view text)
+{
+    uint64_t first = 0x243f6a8885a308d3;
+    uint64_t second = 0x13198a2e03707344;
+
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, text.data() + i, 8);
+        first = (first ^ word) * 0x9e3779b97f4a7c15;
+        first ^= first >> 29;
+        second = (second + word) * 0xc2b2ae3d27d4eb4f;
+        second ^= second >> 31;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, text.data() + i, text.size() - i);
+
+    return {mix(first ^ tail), mix(second + tail), text.size()};
+}
+
+// Tokens mostly follow one another, so their offsets and lines are kept
+// as differences from the previous token, folded to be non-negative.
+static uint64_t fold(int64_t delta)
+{
+    return ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);
+}
+
+static int64_t unfold(uint64_t value)
+{
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+static fs::path directory()
+{
+    if (const char* path = getenv("CPPLOX_CACHE_DIR"))
+        return path;
+    if (const char* path = getenv("XDG_CACHE_HOME"))
+        return fs::path(path) / "cpplox";
+    if (const char* path = getenv("HOME"))
+        return fs::path(path) / ".cache" / "cpplox";
+    return {};
+}
+
+class AstWriter : public Visitor
+{
+    public:
+        std::string out;
+
+        AstWriter(int file)
+        {
+            this->file = file;
+            this->source = SourceTable::text(file);
+        }
+
+        void number(uint64_t value)
+        {
+            // Seven bits at a time, low first; the top bit marks more.
+            while (value >= 0x80)
+            {
+                out += (char) ((value & 0x7f) | 0x80);
+                value >>= 7;
+            }
+            out += (char) value;
+        }
+
+        void text(std::string_view text)
+        {
+            number(text.size());
+            out += text;
+        }
+
+        void token(const Token& token)
+        {
+            out += (char) token.type;
+            const char* lexeme = token.lexeme.data();
+            if ((token.file == file) && (lexeme >= source.data()) &&
+                (lexeme + token.lexeme.size() <= source.data() + source.size()))
+            {
+                out += (char) IN_SOURCE;
+                int64_t offset = lexeme - source.data();
+                number(fold(offset - lastOffset));
+                number(token.lexeme.size());
+                lastOffset = offset;
+            }
+            else
+            {
+                if ((token.file != file) && (token.file != 0))
+                    throw BadEntry();
+                out += (char) ((token.file == file) ? OWN_FILE : MADE_UP);
+                text(token.lexeme);
+            }
+            number(fold((int64_t) token.line - lastLine));
+            number((uint32_t) token.column);
+            lastLine = token.line;
+        }
+
+        void tokens(const vT& tokens)
+        {
+            number(tokens.size());
+            for (const Token& each : tokens)
+                token(each);
+        }
+
+        void stmt(Stmt* stmt)
+        {
+            if (stmt == nullptr) out += (char) NO_NODE;
+            else stmt->accept(*this);
+        }
+
+        void stmts(const vpS& stmts)
+        {
+            number(stmts.size());
+            for (Stmt* each : stmts)
+                stmt(each);
+        }
+
+        void expr(Expr* expr)
+        {
+            if (expr == nullptr) out += (char) NO_NODE;
+            else expr->accept(*this);
+        }
+
+        void exprs(const vpE& exprs)
+        {
+            number(exprs.size());
+            for (Expr* each : exprs)
+                expr(each);
+        }
+
+        void visitBreakStmt(Break* stmt) override
+        {
+            out += (char) BREAK_STMT;
+            token(stmt->breakCMD);
+            text(stmt->loopType);
+        }
+
+        void visitBlockStmt(Block* stmt) override
+        {
+            out += (char) BLOCK_STMT;
+            stmts(stmt->statements);
+        }
+
+        void visitClassStmt(Class* stmt) override
+        {
+            out += (char) CLASS_STMT;
+            token(stmt->name);
+            expr(stmt->superclass);
+            stmts(stmt->methods);
+            stmts(stmt->classMethods);
+        }
+
+        void visitContinueStmt(Continue* stmt) override
+        {
+            out += (char) CONTINUE_STMT;
+            token(stmt->continueCMD);
+            text(stmt->loopType);
+        }
+
+        void visitFetchStmt(Fetch* stmt) override
+        {
+            // Imports are looked up again when the entry is read.
+            out += (char) FETCH_STMT;
+            text(stmt->mode);
+            text(stmt->name);
+        }
+
+        void visitFunctionStmt(Function* stmt) override
+        {
+            out += (char) FUNCTION_STMT;
+            token(stmt->name);
+            out += (char) (stmt->params != nullptr);
+            if (stmt->params != nullptr) tokens(*stmt->params);
+
+            // A body left for later stays that way.
+            LazyBody* lazy = stmt->lazy;
+            out += (char) (lazy != nullptr);
+            if (lazy == nullptr)
+            {
+                stmts(stmt->body);
+                return;
+            }
+            number(lazy->begin);
+            number(lazy->end);
+            number((uint32_t) lazy->line);
+            number((uint32_t) lazy->column);
+            text(lazy->loopType);
+        }
+
+        void visitIfStmt(If* stmt) override
+        {
+            out += (char) IF_STMT;
+            expr(stmt->condition);
+            this->stmt(stmt->thenBranch);
+            this->stmt(stmt->elseBranch);
+        }
+
+        void visitExpressionStmt(Expression* stmt) override
+        {
+            out += (char) EXPRESSION_STMT;
+            expr(stmt->expression);
+        }
+
+        void visitPrintStmt(Print* stmt) override
+        {
+            out += (char) PRINT_STMT;
+            expr(stmt->expression);
+        }
+
+        void visitReturnStmt(Return* stmt) override
+        {
+            out += (char) RETURN_STMT;
+            token(stmt->keyword);
+            expr(stmt->value);
+        }
+
+        void visitVarStmt(Var* stmt) override
+        {
+            out += (char) VAR_STMT;
+            token(stmt->name);
+            expr(stmt->initializer);
+            out += (char) stmt->access;
+        }
+
+        void visitWhileStmt(While* stmt) override
+        {
+            out += (char) WHILE_STMT;
+            expr(stmt->condition);
+            this->stmt(stmt->body);
+        }
+
+        Object visitAssignExpr(Assign* expr) override
+        {
+            out += (char) ASSIGN_EXPR;
+            token(expr->name);
+            this->expr(expr->value);
+            return Object(nullptr);
+        }
+
+        Object visitBinaryExpr(Binary* expr) override
+        {
+            out += (char) BINARY_EXPR;
+            this->expr(expr->left);
+            token(expr->bOperator);
+            this->expr(expr->right);
+            return Object(nullptr);
+        }
+
+        Object visitCallExpr(Call* expr) override
+        {
+            out += (char) CALL_EXPR;
+            this->expr(expr->callee);
+            token(expr->paren);
+            exprs(expr->arguments);
+            return Object(nullptr);
+        }
+
+        Object visitCommaExpr(Comma* expr) override
+        {
+            out += (char) COMMA_EXPR;
+            exprs(expr->expressions);
+            return Object(nullptr);
+        }
+
+        Object visitDictExpr(Dict* expr) override
+        {
+            out += (char) DICT_EXPR;
+            token(expr->brace);
+            exprs(expr->keys);
+            exprs(expr->values);
+            return Object(nullptr);
+        }
+
+        Object visitGetExpr(Get* expr) override
+        {
+            out += (char) GET_EXPR;
+            this->expr(expr->object);
+            token(expr->name);
+            return Object(nullptr);
+        }
+
+        Object visitGroupingExpr(Grouping* expr) override
+        {
+            out += (char) GROUPING_EXPR;
+            this->expr(expr->expression);
+            return Object(nullptr);
+        }
+
+        Object visitIndexExpr(Index* expr) override
+        {
+            out += (char) INDEX_EXPR;
+            this->expr(expr->object);
+            token(expr->bracket);
+            this->expr(expr->index);
+            return Object(nullptr);
+        }
+
+        Object visitLambdaExpr(Lambda* expr) override
+        {
+            out += (char) LAMBDA_EXPR;
+            tokens(expr->params);
+            stmts(expr->body);
+            return Object(nullptr);
+        }
+
+        Object visitListExpr(List* expr) override
+        {
+            out += (char) LIST_EXPR;
+            exprs(expr->elements);
+            return Object(nullptr);
+        }
+
+        Object visitLiteralExpr(Literal* expr) override
+        {
+            out += (char) LITERAL_EXPR;
+            Type kind = type(expr->value);
+            out += (char) kind;
+            if (kind == NUM)
+            {
+                double value = std::any_cast<double>(expr->value.value);
+                out.append((const char*) &value, sizeof(value));
+            }
+            else if (kind == STR)
+                text(std::any_cast<std::string>(expr->value.value));
+            else if (kind == BOOL)
+                out += (char) std::any_cast<bool>(expr->value.value);
+            else if (kind != NONE)
+                throw BadEntry();
+            return Object(nullptr);
+        }
+
+        Object visitLogicalExpr(Logical* expr) override
+        {
+            out += (char) LOGICAL_EXPR;
+            this->expr(expr->left);
+            token(expr->lOperator);
+            this->expr(expr->right);
+            return Object(nullptr);
+        }
+
+        Object visitSetExpr(Set* expr) override
+        {
+            out += (char) SET_EXPR;
+            this->expr(expr->object);
+            token(expr->name);
+            this->expr(expr->value);
+            return Object(nullptr);
+        }
+
+        Object visitSetIndexExpr(SetIndex* expr) override
+        {
+            out += (char) SET_INDEX_EXPR;
+            this->expr(expr->object);
+            token(expr->bracket);
+            this->expr(expr->index);
+            this->expr(expr->value);
+            return Object(nullptr);
+        }
+
+        Object visitSliceExpr(Slice* expr) override
+        {
+            out += (char) SLICE_EXPR;
+            this->expr(expr->object);
+            token(expr->bracket);
+            this->expr(expr->start);
+            this->expr(expr->end);
+            return Object(nullptr);
+        }
+
+        Object visitSuperExpr(Super* expr) override
+        {
+            out += (char) SUPER_EXPR;
+            token(expr->keyword);
+            token(expr->method);
+            return Object(nullptr);
+        }
+
+        Object visitTernaryExpr(Ternary* expr) override
+        {
+            out += (char) TERNARY_EXPR;
+            this->expr(expr->condition);
+            this->expr(expr->trueBranch);
+            this->expr(expr->falseBranch);
+            return Object(nullptr);
+        }
+
+        Object visitThisExpr(This* expr) override
+        {
+            out += (char) THIS_EXPR;
+            token(expr->keyword);
+            return Object(nullptr);
+        }
+
+        Object visitUnaryExpr(Unary* expr) override
+        {
+            out += (char) UNARY_EXPR;
+            token(expr->uOperator);
+            this->expr(expr->right);
+            return Object(nullptr);
+        }
+
+        Object visitVariableExpr(Variable* expr) override
+        {
+            out += (char) VARIABLE_EXPR;
+            token(expr->name);
+            return Object(nullptr);
+        }
+
+    private:
+        int file;
+        std::string_view source;
+        int64_t lastOffset = 0;
+        int64_t lastLine = 0;
+};
+
+class AstReader
+{
+    public:
+        AstReader(int file, std::string_view data)
+        {
+            this->file = file;
+            this->source = SourceTable::text(file);
+            this->at = data.data();
+            this->end = data.data() + data.size();
+        }
+
+        bool done()
+        {
+            return (at == end);
+        }
+
+        uint8_t byte()
+        {
+            if (at == end) throw BadEntry();
+            return (uint8_t) *at++;
+        }
+
+        uint64_t number()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t part = byte();
+                value |= (uint64_t) (part & 0x7f) << shift;
+                if ((part & 0x80) == 0) return value;
+            }
+            throw BadEntry();
+        }
+
+        std::string_view text()
+        {
+            uint64_t length = number();
+            if (length > (uint64_t) (end - at)) throw BadEntry();
+            std::string_view text(at, length);
+            at += length;
+            return text;
+        }
+
+        Token token()
+        {
+            TokenType type = (TokenType) byte();
+            if (type > RIGHT_BRACKET) throw BadEntry();
+
+            std::string_view lexeme;
+            int owner = file;
+            uint8_t kind = byte();
+            if (kind == IN_SOURCE)
+            {
+                uint64_t offset = lastOffset + unfold(number());
+                uint64_t length = number();
+                if ((offset > source.size()) || (length > source.size() - offset))
+                    throw BadEntry();
+                lexeme = source.substr(offset, length);
+                lastOffset = offset;
+            }
+            else if ((kind == OWN_FILE) || (kind == MADE_UP))
+            {
+                lexemes.push_back(std::string(text()));
+                lexeme = lexemes.back();
+                if (kind == MADE_UP) owner = 0;
+            }
+            else
+                throw BadEntry();
+
+            int line = (int) (lastLine + unfold(number()));
+            int column = (int) number();
+            lastLine = line;
+            return Token(type, lexeme, line, column, owner);
+        }
+
+        vT tokens()
+        {
+            vT tokens(count());
+            for (Token& each : tokens)
+                each = token();
+            return tokens;
+        }
+
+        Stmt* stmt()
+        {
+            switch (byte())
+            {
+                case NO_NODE: return nullptr;
+                case BREAK_STMT:
+                {
+                    Token keyword = token();
+                    return new Break(keyword, std::string(text()));
+                }
+                case BLOCK_STMT: return new Block(stmts());
+                case CLASS_STMT:
+                {
+                    Token name = token();
+                    Expr* superclass = expr();
+                    vpS methods = stmts();
+                    return new Class(name, superclass, methods, stmts());
+                }
+                case CONTINUE_STMT:
+                {
+                    Token keyword = token();
+                    return new Continue(keyword, std::string(text()));
+                }
+                case FETCH_STMT:
+                {
+                    std::string mode(text());
+                    std::string name(text());
+                    Module* module = nullptr;
+                    if ((mode == "Lib") || (mode == "File"))
+                    {
+                        // A missing import is reported by parsing instead.
+                        module = Parser::import(mode, name);
+                        if (module == nullptr) throw BadEntry();
+                    }
+                    return new Fetch(mode, name, module);
+                }
+                case FUNCTION_STMT:
+                {
+                    Token name = token();
+                    vT* params = nullptr;
+                    if (byte() != 0) params = new vT(tokens());
+                    if (byte() == 0) return new Function(name, params, stmts());
+
+                    LazyBody* lazy = new LazyBody();
+                    lazy->file = file;
+                    lazy->begin = (unsigned int) number();
+                    lazy->end = (unsigned int) number();
+                    lazy->line = (int) number();
+                    lazy->column = (int) number();
+                    lazy->loopType = text();
+                    if ((lazy->begin > lazy->end) || (lazy->end > source.size()))
+                        throw BadEntry();
+                    Function* function = new Function(name, params, {});
+                    function->lazy = lazy;
+                    return function;
+                }
+                case IF_STMT:
+                {
+                    Expr* condition = expr();
+                    Stmt* thenBranch = stmt();
+                    return new If(condition, thenBranch, stmt());
+                }
+                case EXPRESSION_STMT: return new Expression(expr());
+                case PRINT_STMT: return new Print(expr());
+                case RETURN_STMT:
+                {
+                    Token keyword = token();
+                    return new Return(keyword, expr());
+                }
+                case VAR_STMT:
+                {
+                    Token name = token();
+                    Expr* initializer = expr();
+                    return new Var(name, initializer, byte() != 0);
+                }
+                case WHILE_STMT:
+                {
+                    Expr* condition = expr();
+                    return new While(condition, stmt());
+                }
+            }
+            throw BadEntry();
+        }
+
+        vpS stmts()
+        {
+            vpS stmts(count());
+            for (Stmt*& each : stmts)
+                each = stmt();
+            return stmts;
+        }
+
+        Expr* expr()
+        {
+            switch (byte())
+            {
+                case NO_NODE: return nullptr;
+                case ASSIGN_EXPR:
+                {
+                    Token name = token();
+                    return new Assign(name, expr());
+                }
+                case BINARY_EXPR:
+                {
+                    Expr* left = expr();
+                    Token bOperator = token();
+                    return new Binary(left, bOperator, expr());
+                }
+                case CALL_EXPR:
+                {
+                    Expr* callee = expr();
+                    Token paren = token();
+                    return new Call(callee, paren, exprs());
+                }
+                case COMMA_EXPR: return new Comma(exprs());
+                case DICT_EXPR:
+                {
+                    Token brace = token();
+                    vpE keys = exprs();
+                    return new Dict(brace, keys, exprs());
+                }
+                case GET_EXPR:
+                {
+                    Expr* object = expr();
+                    return new Get(object, token());
+                }
+                case GROUPING_EXPR: return new Grouping(expr());
+                case INDEX_EXPR:
+                {
+                    Expr* object = expr();
+                    Token bracket = token();
+                    return new Index(object, bracket, expr());
+                }
+                case LAMBDA_EXPR:
+                {
+                    vT params = tokens();
+                    return new Lambda(params, stmts());
+                }
+                case LIST_EXPR: return new List(exprs());
+                case LITERAL_EXPR: return new Literal(literal());
+                case LOGICAL_EXPR:
+                {
+                    Expr* left = expr();
+                    Token lOperator = token();
+                    return new Logical(left, lOperator, expr());
+                }
+                case SET_EXPR:
+                {
+                    Expr* object = expr();
+                    Token name = token();
+                    return new Set(object, name, expr());
+                }
+                case SET_INDEX_EXPR:
+                {
+                    Expr* object = expr();
+                    Token bracket = token();
+                    Expr* index = expr();
+                    return new SetIndex(object, bracket, index, expr());
+                }
+                case SLICE_EXPR:
+                {
+                    Expr* object = expr();
+                    Token bracket = token();
+                    Expr* start = expr();
+                    return new Slice(object, bracket, start, expr());
+                }
+                case SUPER_EXPR:
+                {
+                    Token keyword = token();
+                    return new Super(keyword, token());
+                }
+                case TERNARY_EXPR:
+                {
+                    Expr* condition = expr();
+                    Expr* trueBranch = expr();
+                    return new Ternary(condition, trueBranch, expr());
+                }
+                case THIS_EXPR: return new This(token());
+                case UNARY_EXPR:
+                {
+                    Token uOperator = token();
+                    return new Unary(uOperator, expr());
+                }
+                case VARIABLE_EXPR: return new Variable(token());
+            }
+            throw BadEntry();
+        }
+
+        vpE exprs()
+        {
+            vpE exprs(count());
+            for (Expr*& each : exprs)
+                each = expr();
+            return exprs;
+        }
+
+    private:
+        int file;
+        std::string_view source;
+        const char* at;
+        const char* end;
+        int64_t lastOffset = 0;
+        int64_t lastLine = 0;
+
+        // A length, checked against what is left so a damaged entry
+        // cannot ask for a huge allocation.
+        size_t count()
+        {
+            uint64_t count = number();
+            if (count > (uint64_t) (end - at)) throw BadEntry();
+            return count;
+        }
+
+        Object literal()
+        {
+            switch (byte())
+            {
+                case NUM:
+                {
+                    double value;
+                    if (end - at < (long) sizeof(value)) throw BadEntry();
+                    memcpy(&value, at, sizeof(value));
+                    at += sizeof(value);
+                    return Object(value);
+                }
+                case STR: return Object(std::string(text()));
+                case BOOL: return Object(byte() != 0);
+                case NONE: return Object(nullptr);
+            }
+            throw BadEntry();
+        }
+};
+
+static std::string header(const Key& key)
+{
+    std::string header(MAGIC, sizeof(MAGIC));
+    header.append((const char*) &FORMAT_VERSION, sizeof(FORMAT_VERSION));
+    header.append((const char*) &key.check, sizeof(key.check));
+    header.append((const char*) &key.length, sizeof(key.length));
+    return header;
+}
+
+static bool load(const fs::path& path, const Key& key, int file, vpS& statements)
+{
+    std::error_code error;
+    size_t size = fs::file_size(path, error);
+    if (error) return false;
+    std::ifstream in(path, std::ios::binary);
+    std::string data(size, '\0');
+    if (!in.read(data.data(), size)) return false;
+
+    std::string expected = header(key);
+    if (data.compare(0, expected.size(), expected) != 0) return false;
+
+    try
+    {
+        AstReader reader(file, std::string_view(data).substr(expected.size()));
+        statements = reader.stmts();
+        return reader.done();
+    }
+    catch (BadEntry&)
+    {
+        return false;
+    }
+}
+
+static void store(const fs::path& path, const Key& key, int file, vpS& statements)
+{
+    AstWriter writer(file);
+    try
+    {
+        writer.stmts(statements);
+    }
+    catch (BadEntry&)
+    {
+        return;
+    }
+
+    // Written aside and renamed into place, so a reader never sees half
+    // an entry.
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+    fs::path temporary = path;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out << header(key) << writer.out;
+        if (!out) error = std::make_error_code(std::errc::io_error);
+    }
+    if (!error) fs::rename(temporary, path, error);
+    if (error) fs::remove(temporary, error);
+}
+
+// Parsed, waiting for commit().
+struct Pending
+{
+    fs::path path;
+    Key key;
+    int file;
+    vpS statements;
+};
+
+static std::vector<Pending> pending;
+
+static vpS parseOrLoad(int file)
+{
+    fs::path path = AstCache::enabled ? directory() : fs::path();
+    if (path.empty()) return Parser(file).parse();
+
+    Key key = keyOf(SourceTable::text(file));
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long) key.name);
+    path /= std::string(name) + ".ast";
+
+    vpS statements;
+    if (load(path, key, file, statements)) return statements;
+
+    int warnings = Parser::warnings;
+    statements = Parser(file).parse();
+    // Only clean parses are kept, so errors and warnings are reported
+    // every time.
+    if (!Lox::failed() && (Parser::warnings == warnings))
+        pending.push_back({path, key, file, statements});
+    return statements;
+}
+
+vpS AstCache::parse(int file)
+{
+    vpS statements = parseOrLoad(file);
+    SourceTable::seal(file);
+    return statements;
+}
+
+void AstCache::commit()
+{
+    if (!Lox::failed())
+    {
+        for (Pending& entry : pending)
+            store(entry.path, entry.key, entry.file, entry.statements);
+    }
+    pending.clear();
+}
\ No newline at end of file
@@ -1,19 +1,25 @@
 #include "../include/BuiltinFunction.h"
+#include "../include/ArrayObject.h"
+#include "../include/DictObject.h"
 #include "../include/Environment.h"
 #include "../include/Error.h"
 #include "../include/Expr.h"
 #include "../include/Interpreter.h"
 #include "../include/ListObject.h"
 #include "../include/Object.h"
+#include "../include/SequenceObject.h"
 #include "../include/Token.h"
 #include "../include/Types.h"
 #include <cctype>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 Environment builtinSetup()
 {
-    std::vector<std::string> functions = {"clock", "type", "string", "number", "length"};
+    std::vector<std::string> functions = {"clock", "type", "string", "number", "length",
+                                          "Float64Array"};
     Environment builtins;
     for (std::string function : functions)
         builtins.define(function, Object(BuiltinFunction(function)), "VAR");
@@ -25,7 +31,7 @@ BuiltinFunction::BuiltinFunction(std::string mode)
     this->mode = mode;
 }
 
-Object BuiltinFunction::call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments)
+Object BuiltinFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
 {
     (void) expr; // To silence error.
     
@@ -38,7 +44,9 @@ Object BuiltinFunction::call(Interpreter interpreter, Expr* expr, std::vector<Ob
     if (mode == "number")
         return b_number(dynamic_cast<Call *>(expr), arguments[0]);
     if (mode == "length")
-        return b_length(dynamic_cast<Call *>(expr), arguments[0]);
+        return b_length(interpreter, dynamic_cast<Call *>(expr), arguments[0]);
+    if (mode == "Float64Array")
+        return b_float64Array(dynamic_cast<Call *>(expr), arguments[0]);
     return Object(nullptr); // Unreachable.
 }
 
@@ -52,7 +60,7 @@ Object BuiltinFunction::b_type(Object object)
     return Object(object.printType());
 }
 
-Object BuiltinFunction::b_string(Interpreter interpreter, Object object)
+Object BuiltinFunction::b_string(Interpreter& interpreter, Object object)
 {
     return Object(interpreter.stringify(object));
 }
@@ -86,7 +94,7 @@ Object BuiltinFunction::b_number(Call* expr, Object object)
 }
 
 // Only for strings for the time being.
-Object BuiltinFunction::b_length(Call* expr, Object object)
+Object BuiltinFunction::b_length(Interpreter& interpreter, Call* expr, Object object)
 {
     Token callee;
     Variable* check;
@@ -101,13 +109,64 @@ Object BuiltinFunction::b_length(Call* expr, Object object)
     }
     if (type(object) == LIST)
     {
-        std::vector<Object> array = std::any_cast<ListObject>(object.value).array;
-        return Object((double) array.size());
+        ListObject list = std::any_cast<ListObject>(object.value);
+        return Object((double) list.size());
+    }
+    if (type(object) == ARRAY)
+        return Object((double) std::any_cast<ArrayObject>(object.value).size());
+    if (type(object) == DICT)
+        return Object((double) std::any_cast<DictObject>(object.value).size());
+    if (type(object) == SEQ)
+    {
+        double count = 0;
+        std::any_cast<SequenceObject>(object.value).run(interpreter, [&](Object) {
+            count++;
+            return true;
+        });
+        return Object(count);
     }
 
     throw RuntimeError(callee, "Invalid input to length().");
 }
 
+// Float64Array(n) is n zeros; Float64Array(list) copies a list of numbers.
+Object BuiltinFunction::b_float64Array(Call* expr, Object object)
+{
+    if (type(object) == NUM)
+    {
+        double length = std::any_cast<double>(object.value);
+        if ((length < 0) || (length != (size_t) length))
+            throw RuntimeError(expr->paren, "Float64Array length must be a non-negative integer.");
+        // Past what a vector can hold, or what memory can.
+        try
+        {
+            return Object(ArrayObject((size_t) length));
+        }
+        catch (std::length_error& e)
+        {
+            throw RuntimeError(expr->paren, "Float64Array length is too large.");
+        }
+        catch (std::bad_alloc& e)
+        {
+            throw RuntimeError(expr->paren, "Float64Array length is too large.");
+        }
+    }
+    if (type(object) == LIST)
+    {
+        ListObject list = std::any_cast<ListObject>(object.value);
+        std::vector<double> elements(list.size());
+        for (int i = 0; i < list.size(); i++)
+        {
+            if (type(list[i]) != NUM)
+                throw RuntimeError(expr->paren, "Float64Array elements must be numbers.");
+            elements[i] = std::any_cast<double>(list[i].value);
+        }
+        return Object(ArrayObject(std::move(elements)));
+    }
+
+    throw RuntimeError(expr->paren, "Invalid input to Float64Array().");
+}
+
 int BuiltinFunction::arity()
 {
     if (mode == "clock")
@@ -120,6 +179,8 @@ int BuiltinFunction::arity()
         return 1;
     if (mode == "length")
         return 1;
+    if (mode == "Float64Array")
+        return 1;
     return -1; // Unreachable.
 }
 
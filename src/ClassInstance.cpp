@@ -3,6 +3,7 @@
 #include "../include/LoxClass.h"
 #include "../include/Object.h"
 #include "../include/Token.h"
+#include <string>
 
 #define class(obj) std::any_cast<LoxClass *>(obj.value)
 
@@ -13,8 +14,9 @@ ClassInstance::ClassInstance(Object klassObj)
 
 Object ClassInstance::get(Token name)
 {
-    if (fields.contains(name.lexeme))
-        return fields[name.lexeme];
+    auto field = fields.find(name.lexeme);
+    if (field != fields.end())
+        return field->second;
 
     LoxClass* klass = class(klassObj);
     if (klass->hasMethod(name.lexeme))
@@ -23,10 +25,14 @@ Object ClassInstance::get(Token name)
         return Object(method.bind(this));
     }
 
-    throw RuntimeError(name, "Undefined property '" + name.lexeme + "'.");
+    throw RuntimeError(name, "Undefined property '" + std::string(name.lexeme) + "'.");
 }
 
 void ClassInstance::set(Token name, Object value)
 {
-    fields[name.lexeme] = value;
+    auto field = fields.find(name.lexeme);
+    if (field != fields.end())
+        field->second = value;
+    else
+        fields.emplace(name.lexeme, value);
 }
\ No newline at end of file
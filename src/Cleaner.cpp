@@ -165,6 +165,14 @@ void Cleaner::visitCommaExpr(Comma* &expr)
     expr = nullptr;
 }
 
+void Cleaner::visitDictExpr(Dict* &expr)
+{
+    clean(expr->keys);
+    clean(expr->values);
+    delete expr;
+    expr = nullptr;
+}
+
 void Cleaner::visitGetExpr(Get* &expr)
 {
     clean(expr->object);
@@ -179,6 +187,14 @@ void Cleaner::visitGroupingExpr(Grouping* &expr)
     expr = nullptr;
 }
 
+void Cleaner::visitIndexExpr(Index* &expr)
+{
+    clean(expr->object);
+    clean(expr->index);
+    delete expr;
+    expr = nullptr;
+}
+
 void Cleaner::visitLambdaExpr(Lambda* &expr)
 {
     clean(expr->body);
@@ -216,6 +232,24 @@ void Cleaner::visitSetExpr(Set* &expr)
     expr = nullptr;
 }
 
+void Cleaner::visitSetIndexExpr(SetIndex* &expr)
+{
+    clean(expr->object);
+    clean(expr->index);
+    clean(expr->value);
+    delete expr;
+    expr = nullptr;
+}
+
+void Cleaner::visitSliceExpr(Slice* &expr)
+{
+    clean(expr->object);
+    clean(expr->start);
+    clean(expr->end);
+    delete expr;
+    expr = nullptr;
+}
+
 void Cleaner::visitSuperExpr(Super* &expr)
 {
     delete expr;
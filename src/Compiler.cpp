@@ -0,0 +1,529 @@
+#include "../include/Compiler.h"
+#include "../include/Error.h"
+#include "../include/Expr.h"
+#include "../include/Interpreter.h"
+#include "../include/LoxClass.h"
+#include "../include/LoxFunction.h"
+#include "../include/Nodes.h"
+#include "../include/Object.h"
+#include "../include/Quickening.h"
+#include "../include/Stmt.h"
+#include "../include/Token.h"
+#include "../include/TokenType.h"
+#include <any>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+bool Compiler::enabled = true;
+
+Compiler::Compiler(Interpreter& interpreter)
+{
+    this->interpreter = &interpreter;
+}
+
+Thunk* Compiler::compile(Expr* expr)
+{
+    if (expr->compiled == nullptr)
+    {
+        (void) expr->accept(*this); // Unused return value.
+        expr->compiled = new Thunk(std::move(compiled));
+    }
+    return expr->compiled;
+}
+
+// Variables resolved to a scope keep their distance; the rest are looked
+// up as globals (or built-ins) each time, as a later REPL line may
+// define them.
+Thunk Compiler::lookUp(Token name, Expr* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    auto local = interpreter->locals.find(expr);
+    if (local != interpreter->locals.end())
+    {
+        int distance = local->second;
+        return [=]() { return interpreter->environment->getAt(distance, name); };
+    }
+
+    return [=]()
+    {
+        if (interpreter->globals.contains(name.lexeme))
+            return interpreter->globals.get(name);
+        return interpreter->builtins.get(name);
+    };
+}
+
+// Where the variable's value is stored, found as lookUp() finds it but
+// without copying it. Null for a builtin or an undefined name.
+std::function<Object*()> Compiler::locate(Token name, Expr* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    auto local = interpreter->locals.find(expr);
+    if (local != interpreter->locals.end())
+    {
+        int distance = local->second;
+        return [=]() { return interpreter->environment->ancestor(distance)->find(name.lexeme); };
+    }
+
+    return [=]() { return interpreter->globals.find(name.lexeme); };
+}
+
+Thunk Compiler::generic(Expr* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    return [=]() { return expr->accept(*interpreter); };
+}
+
+// An operation on two numbers. A number on the right is kept in the
+// closure rather than evaluated.
+template<typename Operation>
+Thunk Compiler::numeric(Binary* expr, Operation operation)
+{
+    Interpreter* interpreter = this->interpreter;
+    Token bOperator = expr->bOperator;
+    Thunk* left = compile(expr->left);
+
+    auto literal = dynamic_cast<Literal*>(expr->right);
+    if ((literal != nullptr) && isNumber(literal->value))
+    {
+        double right = number(literal->value);
+        return [=]()
+        {
+            Object value = (*left)();
+            if (!isNumber(value))
+                interpreter->checkNumberOperands(bOperator, value, Object(right));
+            return operation(number(value), right);
+        };
+    }
+
+    Thunk* right = compile(expr->right);
+    return [=]()
+    {
+        Object a = (*left)();
+        Object b = (*right)();
+        if (!isNumber(a) || !isNumber(b))
+            interpreter->checkNumberOperands(bOperator, a, b);
+        return operation(number(a), number(b));
+    };
+}
+
+// Statement methods.
+
+void Compiler::visitBreakStmt(Break* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitBlockStmt(Block* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitClassStmt(Class* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitContinueStmt(Continue* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitExpressionStmt(Expression* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitFetchStmt(Fetch* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitFunctionStmt(Function* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitIfStmt(If* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitPrintStmt(Print* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitReturnStmt(Return* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitVarStmt(Var* stmt)
+{
+    (void) stmt;
+}
+
+void Compiler::visitWhileStmt(While* stmt)
+{
+    (void) stmt;
+}
+
+// Expression methods.
+
+Object Compiler::visitAssignExpr(Assign* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    Token name = expr->name;
+    Thunk* value = compile(expr->value);
+
+    auto local = interpreter->locals.find(expr);
+    if (local != interpreter->locals.end())
+    {
+        int distance = local->second;
+        compiled = [=]()
+        {
+            Object result = (*value)();
+            interpreter->environment->assignAt(distance, name, result);
+            return result;
+        };
+    }
+    else
+    {
+        compiled = [=]()
+        {
+            Object result = (*value)();
+            interpreter->globals.assign(name, result);
+            return result;
+        };
+    }
+    return Object(nullptr);
+}
+
+Object Compiler::visitBinaryExpr(Binary* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    Token bOperator = expr->bOperator;
+
+    switch (bOperator.type)
+    {
+        case GREATER:
+            compiled = numeric(expr, [](double a, double b) { return Object(a > b); });
+            break;
+        case GREATER_EQUAL:
+            compiled = numeric(expr, [](double a, double b) { return Object(a >= b); });
+            break;
+        case LESS:
+            compiled = numeric(expr, [](double a, double b) { return Object(a < b); });
+            break;
+        case LESS_EQUAL:
+            compiled = numeric(expr, [](double a, double b) { return Object(a <= b); });
+            break;
+        case MINUS:
+            compiled = numeric(expr, [](double a, double b) { return Object(a - b); });
+            break;
+        case STAR:
+            compiled = numeric(expr, [](double a, double b) { return Object(a * b); });
+            break;
+        case POWER:
+            compiled = numeric(expr, [](double a, double b) { return Object(pow(a, b)); });
+            break;
+        case SLASH:
+            compiled = numeric(expr, [bOperator](double a, double b)
+            {
+                if (b == 0)
+                    throw RuntimeError(bOperator, "Division by zero not allowed.");
+                return Object(a / b);
+            });
+            break;
+        case MOD:
+            compiled = numeric(expr, [bOperator](double a, double b)
+            {
+                if (b == 0)
+                    throw RuntimeError(bOperator, "Cannot compute value mod 0.");
+                int intA = (int) a;
+                int intB = (int) b;
+                if (((a - intA) != 0) or ((b - intB) != 0))
+                    throw RuntimeError(bOperator, "Cannot compute modulus for non-integers.");
+                return Object((double)(intA % intB));
+            });
+            break;
+        case PLUS:
+        {
+            Thunk* left = compile(expr->left);
+            Thunk* right = compile(expr->right);
+            compiled = [=, seen = UNSEEN, misses = 0]() mutable
+            {
+                Object a = (*left)();
+                Object b = (*right)();
+                if ((seen == NUMBERS) && isNumber(a) && isNumber(b))
+                    return Object(number(a) + number(b));
+                if ((seen == STRINGS) && isString(a) && isString(b))
+                    return Object(text(a) + text(b));
+
+                requicken(seen, misses, a, b);
+                return interpreter->plus(expr, a, b);
+            };
+            break;
+        }
+        case EQUAL_EQUAL:
+        case BANG_EQUAL:
+        {
+            bool equal = (bOperator.type == EQUAL_EQUAL);
+            Thunk* left = compile(expr->left);
+            Thunk* right = compile(expr->right);
+            compiled = [=, seen = UNSEEN, misses = 0]() mutable
+            {
+                Object a = (*left)();
+                Object b = (*right)();
+                if ((seen == NUMBERS) && isNumber(a) && isNumber(b))
+                    return Object((number(a) == number(b)) == equal);
+                if ((seen == STRINGS) && isString(a) && isString(b))
+                    return Object((text(a) == text(b)) == equal);
+
+                requicken(seen, misses, a, b);
+                return Object(interpreter->isEqual(a, b) == equal);
+            };
+            break;
+        }
+        default:
+            compiled = generic(expr);
+    }
+    return Object(nullptr);
+}
+
+// Calls to Lox functions and classes keep the last declaration called
+// from here, with its arity already checked. A Lox function read from a
+// variable is also kept whole: while the variable holds that function,
+// the call is made on the one kept, without copying the callee or
+// checking it again. A site that misses too often keeps the last one.
+// A call in tail position hands the callee to the function returning
+// instead of making the call. Anything else goes through invoke().
+Object Compiler::visitCallExpr(Call* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    Thunk* callee = compile(expr->callee);
+    std::function<Object*()> stored;
+    if (auto variable = dynamic_cast<Variable*>(expr->callee))
+        stored = locate(variable->name, variable);
+    std::vector<Thunk*> arguments;
+    for (Expr* argument : expr->arguments)
+        arguments.push_back(compile(argument));
+
+    // The functions kept stay put while a call on one of them runs.
+    compiled = [=, kept = std::deque<LoxFunction>(), cached = (LoxFunction*) nullptr,
+                last = (const void*) nullptr]() mutable
+    {
+        bool tail = interpreter->tailPosition;
+        interpreter->tailPosition = false;
+
+        LoxFunction* lox = nullptr;
+        if (cached != nullptr)
+        {
+            Object* found = stored();
+            LoxFunction* current = (found != nullptr) ?
+                std::any_cast<LoxFunction>(&found->value) : nullptr;
+            if ((current != nullptr) && current->sameAs(*cached)) lox = cached;
+        }
+        Object function;
+        if (lox == nullptr) function = (*callee)();
+
+        std::vector<Object> values;
+        values.reserve(arguments.size());
+        for (Thunk* argument : arguments)
+            values.push_back((*argument)());
+
+        if (lox == nullptr)
+        {
+            lox = std::any_cast<LoxFunction>(&function.value);
+            // A function's arity depends only on its declaration.
+            const void* declaration = (lox != nullptr) ? lox->declaration.params : nullptr;
+            if ((lox != nullptr) && (declaration != last))
+            {
+                interpreter->checkArity(expr, lox->arity(), values.size());
+                last = declaration;
+            }
+            if ((lox != nullptr) && (stored != nullptr) && ((int) kept.size() <= maxMisses))
+            {
+                kept.push_back(std::move(*lox));
+                cached = lox = &kept.back();
+            }
+        }
+        if (lox != nullptr)
+        {
+            if (!tail) return lox->call(*interpreter, expr, std::move(values));
+
+            if (lox == cached) interpreter->tailCallee = *lox;
+            else interpreter->tailCallee = std::move(*lox);
+            interpreter->tailArguments = std::move(values);
+            interpreter->tailCalling = true;
+            return Object(nullptr);
+        }
+
+        LoxClass* klass = std::any_cast<LoxClass>(&function.value);
+        if ((klass != nullptr) && (klass->metaclass != nullptr))
+        {
+            if (klass->metaclass != last)
+            {
+                interpreter->checkArity(expr, klass->arity(), values.size());
+                last = klass->metaclass;
+            }
+            return klass->call(*interpreter, expr, std::move(values));
+        }
+
+        return interpreter->invoke(function, values, expr);
+    };
+    return Object(nullptr);
+}
+
+Object Compiler::visitCommaExpr(Comma* expr)
+{
+    std::vector<Thunk*> expressions;
+    for (Expr* expression : expr->expressions)
+        expressions.push_back(compile(expression));
+
+    compiled = [=]()
+    {
+        for (int i = 0; i < (int) expressions.size() - 1; i++)
+            (void) (*expressions[i])();
+        return (*expressions.back())();
+    };
+    return Object(nullptr);
+}
+
+Object Compiler::visitDictExpr(Dict* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitGetExpr(Get* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitGroupingExpr(Grouping* expr)
+{
+    // Forwarded rather than copied: the operand's closure may keep state.
+    Thunk* expression = compile(expr->expression);
+    compiled = [expression]() { return (*expression)(); };
+    return Object(nullptr);
+}
+
+Object Compiler::visitIndexExpr(Index* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitLambdaExpr(Lambda* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitListExpr(List* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitLiteralExpr(Literal* expr)
+{
+    compiled = [value = expr->value]() { return value; };
+    return Object(nullptr);
+}
+
+Object Compiler::visitLogicalExpr(Logical* expr)
+{
+    bool isOr = (expr->lOperator.type == OR);
+    Thunk* left = compile(expr->left);
+    Thunk* right = compile(expr->right);
+
+    compiled = [=]()
+    {
+        Object value = (*left)();
+        if (truthy(value) == isOr) return value;
+        return (*right)();
+    };
+    return Object(nullptr);
+}
+
+Object Compiler::visitSetExpr(Set* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitSetIndexExpr(SetIndex* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitSliceExpr(Slice* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitSuperExpr(Super* expr)
+{
+    compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitTernaryExpr(Ternary* expr)
+{
+    Thunk* condition = compile(expr->condition);
+    Thunk* trueBranch = compile(expr->trueBranch);
+    Thunk* falseBranch = compile(expr->falseBranch);
+
+    compiled = [=]()
+    {
+        if (truthy((*condition)())) return (*trueBranch)();
+        return (*falseBranch)();
+    };
+    return Object(nullptr);
+}
+
+Object Compiler::visitThisExpr(This* expr)
+{
+    compiled = lookUp(expr->keyword, expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitUnaryExpr(Unary* expr)
+{
+    Interpreter* interpreter = this->interpreter;
+    Token uOperator = expr->uOperator;
+    Thunk* right = compile(expr->right);
+
+    if (uOperator.type == BANG)
+        compiled = [=]() { return Object(!truthy((*right)())); };
+    else if (uOperator.type == MINUS)
+    {
+        compiled = [=]()
+        {
+            Object value = (*right)();
+            if (!isNumber(value))
+                interpreter->checkNumberOperand(uOperator, value);
+            return Object(-number(value));
+        };
+    }
+    else
+        compiled = generic(expr);
+    return Object(nullptr);
+}
+
+Object Compiler::visitVariableExpr(Variable* expr)
+{
+    compiled = lookUp(expr->name, expr);
+    return Object(nullptr);
+}
\ No newline at end of file
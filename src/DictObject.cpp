@@ -0,0 +1,327 @@
+#include "../include/DictObject.h"
+#include "../include/Error.h"
+#include "../include/Expr.h"
+#include "../include/Hash.h"
+#include "../include/Interpreter.h"
+#include "../include/ListObject.h"
+#include "../include/Object.h"
+#include "../include/Token.h"
+#include "../include/Types.h"
+#include <any>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static std::string_view functions[] = {
+    "get", "set", "has", "remove", "keys", "values"
+};
+
+static const size_t GROUP = 16;
+// Full slots hold the 7-bit hash tag (0-127), so both markers are negative.
+static const int8_t EMPTY = -128;
+static const int8_t DELETED = -2;
+
+// Bit i is set when control byte i of the group equals value.
+static uint32_t matchByte(const int8_t* group, int8_t value)
+{
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128((const __m128i *) group);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP; i++)
+    {
+        if (group[i] == value) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
+
+// Bit i is set when slot i of the group is EMPTY or DELETED.
+static uint32_t matchFree(const int8_t* group)
+{
+#ifdef __SSE2__
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP; i++)
+    {
+        if (group[i] < 0) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
+
+static int8_t tagOf(size_t hash)
+{
+    return (int8_t) (hash & 0x7f);
+}
+
+// Groups are visited in triangular steps, which reach every group
+// of a power-of-two table.
+static long findSlot(DictTable& table, const Object& key, size_t hash)
+{
+    size_t groups = table.control.size() / GROUP;
+    size_t group = (hash >> 7) & (groups - 1);
+
+    for (size_t step = 1; ; step++)
+    {
+        const int8_t* control = table.control.data() + group * GROUP;
+        for (uint32_t bits = matchByte(control, tagOf(hash)); bits != 0; bits &= bits - 1)
+        {
+            size_t slot = group * GROUP + std::countr_zero(bits);
+            DictTable::Entry& entry = table.entries[table.slots[slot]];
+            if ((entry.hash == hash) && equalObjects(entry.key, key))
+                return (long) slot;
+        }
+        // A key is never placed past a group with an empty slot.
+        if (matchByte(control, EMPTY) != 0) return -1;
+        group = (group + step) & (groups - 1);
+    }
+}
+
+static size_t freeSlot(DictTable& table, size_t hash)
+{
+    size_t groups = table.control.size() / GROUP;
+    size_t group = (hash >> 7) & (groups - 1);
+
+    for (size_t step = 1; ; step++)
+    {
+        uint32_t bits = matchFree(table.control.data() + group * GROUP);
+        if (bits != 0) return group * GROUP + std::countr_zero(bits);
+        group = (group + step) & (groups - 1);
+    }
+}
+
+static void rehash(DictTable& table, size_t capacity)
+{
+    // Drop removed entries, keeping the rest in order.
+    std::vector<DictTable::Entry> entries;
+    entries.reserve(table.count);
+    for (DictTable::Entry& entry : table.entries)
+    {
+        if (entry.live) entries.push_back(std::move(entry));
+    }
+    table.entries = std::move(entries);
+
+    table.control.assign(capacity, EMPTY);
+    table.slots.assign(capacity, -1);
+    table.growthLeft = capacity * 7 / 8 - table.count;
+
+    for (size_t i = 0; i < table.entries.size(); i++)
+    {
+        size_t slot = freeSlot(table, table.entries[i].hash);
+        table.control[slot] = tagOf(table.entries[i].hash);
+        table.slots[slot] = (int) i;
+    }
+}
+
+static std::string show(Interpreter& interpreter, const Object& object)
+{
+    if (type(object) == STR)
+        return "\"" + interpreter.stringify(object) + "\"";
+    return interpreter.stringify(object);
+}
+
+// class DictObject
+
+DictObject::DictObject()
+{
+    this->table = std::make_shared<DictTable>();
+    rehash(*this->table, GROUP);
+}
+
+Object DictObject::get(Token name)
+{
+    for (std::string_view function : functions)
+    {
+        if (function == name.lexeme)
+        {
+            DictFunction method(function);
+            method.bind(*this);
+            return Object(method);
+        }
+    }
+
+    throw RuntimeError(name, "Undefined property or method '" + std::string(name.lexeme) + "'.");
+}
+
+int DictObject::size()
+{
+    return (int) table->count;
+}
+
+void DictObject::checkKey(Token where, const Object& key)
+{
+    if (!isHashable(key))
+        throw RuntimeError(where,
+            "Dictionary keys must be numbers, strings, booleans, nil or instances.");
+}
+
+Object* DictObject::find(const Object& key)
+{
+    if (!isHashable(key)) return nullptr;
+
+    long slot = findSlot(*table, key, hashObject(key));
+    if (slot == -1) return nullptr;
+    return &table->entries[table->slots[slot]].value;
+}
+
+void DictObject::insert(Object key, Object value)
+{
+    size_t hash = hashObject(key);
+    long found = findSlot(*table, key, hash);
+    if (found != -1)
+    {
+        table->entries[table->slots[found]].value = value;
+        return;
+    }
+
+    // Entries never outnumber slots, so a full entry array also
+    // means it is time to compact.
+    size_t capacity = table->control.size();
+    if ((table->growthLeft == 0) || (table->entries.size() == capacity))
+    {
+        // Grow when live keys fill half the usable slots; otherwise
+        // the space is held by removed keys and rebuilding frees it.
+        if (table->count * 2 >= capacity * 7 / 8) capacity *= 2;
+        rehash(*table, capacity);
+    }
+
+    size_t slot = freeSlot(*table, hash);
+    if (table->control[slot] == EMPTY) table->growthLeft--;
+    table->control[slot] = tagOf(hash);
+    table->slots[slot] = (int) table->entries.size();
+    table->entries.push_back({key, value, hash, true});
+    table->count++;
+}
+
+bool DictObject::erase(const Object& key)
+{
+    if (!isHashable(key)) return false;
+
+    long slot = findSlot(*table, key, hashObject(key));
+    if (slot == -1) return false;
+
+    DictTable::Entry& entry = table->entries[table->slots[slot]];
+    entry.live = false;
+    entry.key = Object(nullptr);
+    entry.value = Object(nullptr);
+    table->slots[slot] = -1;
+    table->count--;
+
+    // No probe ever went past a group that still has an empty slot,
+    // so the slot can become empty again instead of a tombstone.
+    size_t group = slot - (slot % GROUP);
+    if (matchByte(table->control.data() + group, EMPTY) != 0)
+    {
+        table->control[slot] = EMPTY;
+        table->growthLeft++;
+    }
+    else
+        table->control[slot] = DELETED;
+    return true;
+}
+
+ListObject DictObject::keys()
+{
+    std::vector<Object> keys;
+    keys.reserve(table->count);
+    for (DictTable::Entry& entry : table->entries)
+    {
+        if (entry.live) keys.push_back(entry.key);
+    }
+    return ListObject(std::move(keys));
+}
+
+ListObject DictObject::values()
+{
+    std::vector<Object> values;
+    values.reserve(table->count);
+    for (DictTable::Entry& entry : table->entries)
+    {
+        if (entry.live) values.push_back(entry.value);
+    }
+    return ListObject(std::move(values));
+}
+
+std::string DictObject::toString(Interpreter& interpreter)
+{
+    std::string string = "{";
+
+    bool first = true;
+    for (DictTable::Entry& entry : table->entries)
+    {
+        if (!entry.live) continue;
+        if (!first) string += ", ";
+        string += show(interpreter, entry.key) + ": " + show(interpreter, entry.value);
+        first = false;
+    }
+
+    string += "}";
+    return string;
+}
+
+// class DictFunction
+
+DictFunction::DictFunction(std::string_view mode)
+{
+    this->mode = mode;
+}
+
+void DictFunction::bind(DictObject& instance)
+{
+    this->instance = instance;
+}
+
+Object DictFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
+{
+    (void) interpreter;
+    Call* call = (Call *) expr;
+
+    if (mode == "keys")
+        return Object(instance.keys());
+    if (mode == "values")
+        return Object(instance.values());
+
+    DictObject::checkKey(call->paren, arguments[0]);
+    if (mode == "get")
+    {
+        Object* value = instance.find(arguments[0]);
+        return (value != nullptr) ? *value : Object(nullptr);
+    }
+    if (mode == "set")
+    {
+        instance.insert(arguments[0], arguments[1]);
+        return Object(nullptr);
+    }
+    if (mode == "has")
+        return Object(instance.find(arguments[0]) != nullptr);
+    if (mode == "remove")
+    {
+        Object* value = instance.find(arguments[0]);
+        if (value == nullptr)
+            throw RuntimeError(call->paren, "Key not found.");
+        Object removed = *value;
+        instance.erase(arguments[0]);
+        return removed;
+    }
+    return Object(nullptr); // Unreachable.
+}
+
+int DictFunction::arity()
+{
+    if ((mode == "keys") || (mode == "values")) return 0;
+    if (mode == "set") return 2;
+    return 1;
+}
+
+std::string DictFunction::toString()
+{
+    return "<dictionary method " + std::string(mode) + ">";
+}
\ No newline at end of file
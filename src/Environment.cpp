@@ -19,6 +19,43 @@ Environment::Environment(Environment* enclosing)
     this->enclosing = enclosing;
 }
 
+// Whether the name is declared here or in a module fetched here.
+bool Environment::contains(std::string_view name)
+{
+    return (holder(name) != nullptr);
+}
+
+// This environment, or the environment of a module fetched here, that
+// declares the name.
+Environment* Environment::holder(std::string_view name)
+{
+    if (values.contains(name)) return this;
+    for (Environment* module : imports)
+    {
+        Environment* found = module->holder(name);
+        if (found != nullptr) return found;
+    }
+    return nullptr;
+}
+
+// Where the value of the name is stored, searching as get() does, or
+// nullptr if it isn't declared.
+Object* Environment::find(std::string_view name)
+{
+    for (Environment* current = this; current != nullptr; current = current->enclosing)
+    {
+        auto it = current->values.find(name);
+        if (it != current->values.end()) return &it->second;
+
+        for (Environment* module : current->imports)
+        {
+            Environment* found = module->holder(name);
+            if (found != nullptr) return &found->values.find(name)->second;
+        }
+    }
+    return nullptr;
+}
+
 Object Environment::get(Token name)
 {    
     auto it = values.find(name.lexeme);
@@ -32,38 +69,56 @@ Object Environment::get(Token name)
             return obj;
 
         throw RuntimeError(name,
-                "Uninitialized variable '" + name.lexeme + "'.");
+                "Uninitialized variable '" + std::string(name.lexeme) + "'.");
+    }
+
+    for (Environment* module : imports)
+    {
+        Environment* found = module->holder(name.lexeme);
+        if (found != nullptr) return found->get(name);
     }
 
-    else if (enclosing != nullptr)
+    if (enclosing != nullptr)
         return enclosing->get(name);
 
-    throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
+    throw RuntimeError(name, "Undefined variable '" + std::string(name.lexeme) + "'.");
 }
 
 void Environment::assign(Token name, Object value)
 {    
-    if (values.contains(name.lexeme))
+    auto it = values.find(name.lexeme);
+    if (it != values.end())
     {
-        if (varAccess[name.lexeme] == FIX_DEC)
-            throw RuntimeError(name, "Fixed variable " + name.lexeme + " cannot be re-assigned.");
-        values[name.lexeme] = value;
+        if (varAccess.find(name.lexeme)->second == FIX_DEC)
+            throw RuntimeError(name, "Fixed variable " + std::string(name.lexeme) +
+                               " cannot be re-assigned.");
+        it->second = value;
         return;
     }
 
+    for (Environment* module : imports)
+    {
+        Environment* found = module->holder(name.lexeme);
+        if (found != nullptr)
+        {
+            found->assign(name, value);
+            return;
+        }
+    }
+
     if (enclosing != nullptr)
     {
         enclosing->assign(name, value);
         return;
     }
 
-    throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
+    throw RuntimeError(name, "Undefined variable '" + std::string(name.lexeme) + "'.");
 }
 
-void Environment::define(std::string name, Object value, bool access)
+void Environment::define(std::string_view name, Object value, bool access)
 {
-    values[name] = value;
-    varAccess[name] = access;
+    values.insert_or_assign(std::string(name), value);
+    varAccess.insert_or_assign(std::string(name), access);
 }
 
 Environment* Environment::ancestor(int distance)
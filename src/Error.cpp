@@ -68,10 +68,4 @@ ContinueError::ContinueError(Token token, std::string loopType)
 {
 	this->token = token;
 	this->loopType = loopType;
-}
-
-// Return.
-ReturnValue::ReturnValue(Object value)
-{
-	this->value = value;
 }
\ No newline at end of file
@@ -11,7 +11,10 @@
 Expr::Expr() = default;
 
 // Destructor.
-Expr::~Expr() = default;
+Expr::~Expr()
+{
+    delete compiled;
+}
 
 // Assign.
 Assign::Assign(Token name, Expr* value)
@@ -117,6 +120,33 @@ bool Comma::operator==(Expr& other)
     return (this->expressions == check->expressions);
 }
 
+// Dict.
+Dict::Dict(Token brace, vpE keys, vpE values)
+{
+    this->brace = brace;
+    this->keys = keys;
+    this->values = values;
+}
+
+Object Dict::accept(Visitor& visitor)
+{
+    return visitor.visitDictExpr(this);
+}
+
+void Dict::remove(Cleaner& cleaner, Expr* &expr)
+{
+    cleaner.visitDictExpr(reinterpret_cast<Dict *&>(expr));
+}
+
+bool Dict::operator==(Expr& other)
+{
+    auto check = dynamic_cast<Dict *>(&other);
+    if (!check) return false;
+    return ((this->brace == check->brace) &&
+            (this->keys == check->keys) &&
+            (this->values == check->values));
+}
+
 // Get.
 Get::Get(Expr* object, Token name)
 {
@@ -165,6 +195,33 @@ bool Grouping::operator==(Expr& other)
     return (*(this->expression) == *(check->expression));
 }
 
+// Index.
+Index::Index(Expr* object, Token bracket, Expr* index)
+{
+    this->object = object;
+    this->bracket = bracket;
+    this->index = index;
+}
+
+Object Index::accept(Visitor& visitor)
+{
+    return visitor.visitIndexExpr(this);
+}
+
+void Index::remove(Cleaner& cleaner, Expr* &expr)
+{
+    cleaner.visitIndexExpr(reinterpret_cast<Index *&>(expr));
+}
+
+bool Index::operator==(Expr& other)
+{
+    auto check = dynamic_cast<Index *>(&other);
+    if (!check) return false;
+    return ((*(this->object) == *(check->object)) &&
+            (this->bracket == check->bracket) &&
+            (*(this->index) == *(check->index)));
+}
+
 // Lambda.
 Lambda::Lambda(vT params, vpS body)
 {
@@ -298,6 +355,66 @@ bool Set::operator==(Expr& other)
             (*(this->value) == *(check->value)));
 }
 
+// SetIndex.
+SetIndex::SetIndex(Expr* object, Token bracket, Expr* index, Expr* value)
+{
+    this->object = object;
+    this->bracket = bracket;
+    this->index = index;
+    this->value = value;
+}
+
+Object SetIndex::accept(Visitor& visitor)
+{
+    return visitor.visitSetIndexExpr(this);
+}
+
+void SetIndex::remove(Cleaner& cleaner, Expr* &expr)
+{
+    cleaner.visitSetIndexExpr(reinterpret_cast<SetIndex *&>(expr));
+}
+
+bool SetIndex::operator==(Expr& other)
+{
+    auto check = dynamic_cast<SetIndex *>(&other);
+    if (!check) return false;
+    return ((*(this->object) == *(check->object)) &&
+            (this->bracket == check->bracket) &&
+            (*(this->index) == *(check->index)) &&
+            (*(this->value) == *(check->value)));
+}
+
+// Slice.
+Slice::Slice(Expr* object, Token bracket, Expr* start, Expr* end)
+{
+    this->object = object;
+    this->bracket = bracket;
+    this->start = start;
+    this->end = end;
+}
+
+Object Slice::accept(Visitor& visitor)
+{
+    return visitor.visitSliceExpr(this);
+}
+
+void Slice::remove(Cleaner& cleaner, Expr* &expr)
+{
+    cleaner.visitSliceExpr(reinterpret_cast<Slice *&>(expr));
+}
+
+bool Slice::operator==(Expr& other)
+{
+    auto check = dynamic_cast<Slice *>(&other);
+    if (!check) return false;
+    if ((this->start == nullptr) != (check->start == nullptr)) return false;
+    if ((this->end == nullptr) != (check->end == nullptr)) return false;
+    return ((*(this->object) == *(check->object)) &&
+            (this->bracket == check->bracket) &&
+            ((this->start == nullptr) || (*(this->start) == *(check->start))) &&
+            ((this->end == nullptr) || (*(this->end) == *(check->end))));
+}
+
 // Super.
 Super::Super(Token keyword, Token method)
 {
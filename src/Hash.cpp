@@ -0,0 +1,142 @@
+#include "../include/Hash.h"
+#include "../include/Classes.h"
+#include "../include/Object.h"
+#include "../include/Overloads.h"
+#include <any>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// Type tags keep e.g. 1, true and "1" apart before mixing.
+enum HashTag : uint64_t { H_NUM = 1, H_STR, H_BOOL, H_NIL, H_INST };
+
+static bool isNil(const std::any& value)
+{
+    // Uninitialized variables are held as an int vector (see visitVarStmt).
+    return ((value.type() == typeid(std::nullptr_t)) ||
+            (value.type() == typeid(std::vector<int>)));
+}
+
+// splitmix64 finalizer: std::hash is the identity for pointers and integers,
+// which clusters badly in a power-of-two table.
+static uint64_t mix(uint64_t hash)
+{
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+bool isHashable(const Object& object)
+{
+    const std::any& value = object.value;
+    if (value.type() == typeid(double))
+        // NaN is never equal to itself.
+        return !std::isnan(std::any_cast<double>(value));
+    return ((value.type() == typeid(std::string)) ||
+            (value.type() == typeid(bool)) ||
+            (value.type() == typeid(LoxInstance *)) ||
+            isNil(value));
+}
+
+size_t hashObject(const Object& object)
+{
+    const std::any& value = object.value;
+    uint64_t hash = 0;
+    uint64_t tag = H_NIL;
+
+    if (value.type() == typeid(double))
+    {
+        double number = std::any_cast<double>(value);
+        if (number == 0) number = 0; // -0.0 == 0.0
+        hash = std::bit_cast<uint64_t>(number);
+        tag = H_NUM;
+    }
+    else if (value.type() == typeid(std::string))
+    {
+        hash = std::hash<std::string>()(*std::any_cast<std::string>(&value));
+        tag = H_STR;
+    }
+    else if (value.type() == typeid(bool))
+    {
+        hash = std::any_cast<bool>(value);
+        tag = H_BOOL;
+    }
+    else if (value.type() == typeid(LoxInstance *))
+    {
+        hash = (uint64_t) (uintptr_t) std::any_cast<LoxInstance *>(value);
+        tag = H_INST;
+    }
+
+    return (size_t) mix(hash ^ (tag << 56));
+}
+
+bool equalObjects(const Object& a, const Object& b)
+{
+    if (isNil(a.value) && isNil(b.value))
+        return true;
+
+    if (isNil(a.value)) return false;
+
+    return (a.value == b.value);
+}
+
+// class HashIndex
+
+HashIndex::HashIndex(const Object* elements, int length)
+{
+    this->elements = elements;
+
+    // At most half full, so probe sequences stay short.
+    size_t capacity = 16;
+    while (capacity < (size_t) length * 2)
+        capacity <<= 1;
+    slots.resize(capacity);
+    mask = capacity - 1;
+
+    for (int i = 0; i < length; i++)
+    {
+        if (!isHashable(elements[i])) continue;
+
+        size_t hash = hashObject(elements[i]);
+        Slot& slot = probe(elements[i], hash);
+        if (slot.first == -1)
+        {
+            slot.hash = hash;
+            slot.first = i;
+        }
+        slot.last = i;
+    }
+}
+
+int HashIndex::first(const Object& value)
+{
+    if (!isHashable(value)) return -1;
+    return probe(value, hashObject(value)).first;
+}
+
+int HashIndex::last(const Object& value)
+{
+    if (!isHashable(value)) return -1;
+    return probe(value, hashObject(value)).last;
+}
+
+HashIndex::Slot& HashIndex::probe(const Object& value, size_t hash)
+{
+    size_t i = hash & mask;
+    while (true)
+    {
+        Slot& slot = slots[i];
+        if (slot.first == -1)
+            return slot;
+        if ((slot.hash == hash) && equalObjects(elements[slot.first], value))
+            return slot;
+        i = (i + 1) & mask;
+    }
+}
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "../include/Interpreter.h"
+#include "../include/ArrayObject.h"
 #include "../include/Cleaner.h"
 #include "../include/BuiltinFunction.h"
 #include "../include/ClassInstance.h"
+#include "../include/Compiler.h"
+#include "../include/DictObject.h"
 #include "../include/Error.h"
 #include "../include/Expr.h"
+#include "../include/Hash.h"
 #include "../include/ListObject.h"
 #include "../include/Lox.h"
 #include "../include/LoxCallable.h"
@@ -13,6 +17,8 @@
 #include "../include/Nodes.h"
 #include "../include/Object.h"
 #include "../include/Overloads.h"
+#include "../include/Quickening.h"
+#include "../include/SequenceObject.h"
 #include "../include/Stmt.h"
 #include "../include/Types.h"
 #include <algorithm>
@@ -23,6 +29,7 @@
 #include <string>
 #include <typeinfo>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #define double(obj) std::any_cast<double>(obj.value)
@@ -35,12 +42,21 @@
 #define classinst(obj) std::any_cast<LoxClass *>(obj.value)
 #define list(obj) std::any_cast<ListObject>(obj.value)
 #define listfunc(obj) std::any_cast<ListFunction>(obj.value)
+#define sequence(obj) std::any_cast<SequenceObject>(obj.value)
+#define seqfunc(obj) std::any_cast<SequenceFunction>(obj.value)
+#define dict(obj) std::any_cast<DictObject>(obj.value)
+#define dictfunc(obj) std::any_cast<DictFunction>(obj.value)
+#define array(obj) std::any_cast<ArrayObject>(obj.value)
+#define arrayfunc(obj) std::any_cast<ArrayFunction>(obj.value)
 #define time(obj) std::any_cast<time_t>(obj.value)
 
 #define VAR_DEC true
 #define FIX_DEC false
 
 // Constructor.
+int Interpreter::maxDepth = 100000;
+char* Interpreter::stackLimit = nullptr;
+
 Interpreter::Interpreter()
 {
     this->builtins = builtinSetup();
@@ -64,6 +80,7 @@ void Interpreter::interpret(vpS statements)
     {
         error.show();
     }
+    catch (AbortError&) {}
 }
 
 void Interpreter::execute(Stmt* stmt)
@@ -73,10 +90,12 @@ void Interpreter::execute(Stmt* stmt)
 
 Object Interpreter::evaluate(Expr* expr)
 {
-    return expr->accept(*this);
+    if (expr->compiled != nullptr) return (*expr->compiled)();
+    if (!Compiler::enabled) return expr->accept(*this);
+    return (*Compiler(*this).compile(expr))();
 }
 
-void Interpreter::executeBlock(vpS statements, Environment& environment)
+void Interpreter::executeBlock(const vpS& statements, Environment& environment)
 {
     Environment* previous = this->environment;
     try
@@ -86,23 +105,21 @@ void Interpreter::executeBlock(vpS statements, Environment& environment)
         for (Stmt* stmt: statements)
         {
             execute(stmt);
+            if (returning) break;
             // if (cleaner.cleanable(stmt))
             //     cleaner.clean(stmt);
         }
     }
-    catch (RuntimeError& error)
-    {
-        this->environment = previous;
-        throw error;
-    }
     // We need to catch it here (and rethrow it) so that
     // the environment "unwrapping" happens smoothly.
     // C++ doesn't have "finally" clauses, so this is the
     // closest thing we have.
-    catch (ContinueError& error)
+    // Callables share this interpreter, so returns and
+    // breaks have to unwind the environment too.
+    catch (...)
     {
         this->environment = previous;
-        throw error;
+        throw;
     }
     this->environment = previous;
 }
@@ -126,6 +143,12 @@ void Interpreter::visitBreakStmt(Break* stmt)
 
 void Interpreter::visitBlockStmt(Block* stmt)
 {
+    // On the heap when a closure made in the block may outlive it.
+    if (stmt->makesClosures)
+    {
+        executeBlock(stmt->statements, *new Environment(environment));
+        return;
+    }
     Environment newEnv(environment);
     executeBlock(stmt->statements, newEnv);
 }
@@ -167,26 +190,30 @@ void Interpreter::visitClassStmt(Class* stmt)
         superclassPtr = new LoxClass(super);
     }
 
-    std::map<std::string, LoxFunction> classMethods;
+    std::string name(stmt->name.lexeme);
+
+    std::map<std::string, LoxFunction, std::less<>> classMethods;
     for (Stmt* stmt : stmt->classMethods)
     {
         auto func = dynamic_cast<Function *>(stmt);
         LoxFunction function = LoxFunction(*func, environment, false);
-        classMethods[func->name.lexeme] = function;
+        std::string methodName(func->name.lexeme);
+        classMethods[methodName] = function;
     }
 
-    LoxClass* metaclassPtr = new LoxClass(stmt->name.lexeme + " metaclass", nullptr, nullptr,
+    LoxClass* metaclassPtr = new LoxClass(name + " metaclass", nullptr, nullptr,
                                   classMethods);
 
-    std::map<std::string, LoxFunction> methods;
+    std::map<std::string, LoxFunction, std::less<>> methods;
     for (Stmt* stmt : stmt->methods)
     {
         auto func = dynamic_cast<Function *>(stmt);
         LoxFunction function = LoxFunction(*func, environment, (func->name.lexeme == "init"));
-        methods[func->name.lexeme] = function;
+        std::string methodName(func->name.lexeme);
+        methods[methodName] = function;
     }
 
-    LoxClass klass = LoxClass(stmt->name.lexeme, metaclassPtr, superclassPtr, methods);
+    LoxClass klass = LoxClass(name, metaclassPtr, superclassPtr, methods);
 
     if (stmt->superclass != nullptr)
         environment = environment->enclosing;
@@ -203,7 +230,8 @@ void Interpreter::visitExpressionStmt(Expression* stmt)
             std::cout << stringify(value) << '\n';
     }
     else if (!(dynamic_cast<Assign *>(stmt->expression)) &&
-        !(dynamic_cast<Set *>(stmt->expression)))
+        !(dynamic_cast<Set *>(stmt->expression)) &&
+        !(dynamic_cast<SetIndex *>(stmt->expression)))
             visitPrintStmt(new Print(stmt->expression));
     else
         evaluate(stmt->expression);
@@ -215,6 +243,25 @@ void Interpreter::visitFetchStmt(Fetch* stmt)
     {
         // ...
     }
+
+    else
+    {
+        Module* module = stmt->module;
+        if (!module->executed)
+        {
+            module->executed = true;
+            Environment* moduleEnvironment = new Environment(&globals);
+            executeBlock(module->statements, *moduleEnvironment);
+            module->environment = moduleEnvironment;
+        }
+
+        // A module still running (fetched by a file it fetches) is left
+        // out, so imports never form a cycle.
+        std::vector<Environment*>& imports = environment->imports;
+        if ((module->environment != nullptr) &&
+            (std::find(imports.begin(), imports.end(), module->environment) == imports.end()))
+            imports.push_back(module->environment);
+    }
 }
 
 void Interpreter::visitFunctionStmt(Function* stmt)
@@ -245,10 +292,15 @@ void Interpreter::visitPrintStmt(Print* stmt)
 void Interpreter::visitReturnStmt(Return* stmt)
 {
     Object value(nullptr);
+    if (stmt->value != nullptr)
+    {
+        // A call to a Lox function is left to the function returning.
+        tailPosition = (dynamic_cast<Call*>(stmt->value) != nullptr);
+        value = evaluate(stmt->value);
+    }
 
-    if (stmt->value != nullptr) value = evaluate(stmt->value);
-
-    throw ReturnValue(value);
+    returned = std::move(value);
+    returning = true;
 }
 
 void Interpreter::visitVarStmt(Var* stmt)
@@ -266,27 +318,37 @@ void Interpreter::visitVarStmt(Var* stmt)
 void Interpreter::visitWhileStmt(While* stmt)
 {
     loopLevel++;
-    while(isTruthy(evaluate(stmt->condition)))
+    try
     {
-        try
-        {
-            execute(stmt->body);
-        }
-        catch (BreakError& error)
-        {
-            (void) error;
-            break;
-        }
-        catch (ContinueError& error)
+        while(isTruthy(evaluate(stmt->condition)))
         {
-            if (error.loopType == "forLoop")
+            try
+            {
+                execute(stmt->body);
+                if (returning) break;
+            }
+            catch (BreakError& error)
+            {
+                (void) error;
+                break;
+            }
+            catch (ContinueError& error)
             {
-                auto body = dynamic_cast<Block*>(stmt->body);
-                vpS statements = body->statements;
-                execute(statements[statements.size() - 1]);
+                if (error.loopType == "forLoop")
+                {
+                    auto body = dynamic_cast<Block*>(stmt->body);
+                    vpS statements = body->statements;
+                    execute(statements[statements.size() - 1]);
+                }
             }
         }
     }
+    catch (...)
+    {
+        // An error leaving the loop.
+        loopLevel--;
+        throw;
+    }
     loopLevel--;
 }
 
@@ -326,42 +388,60 @@ Object Interpreter::visitBinaryExpr(Binary* expr)
     Object left = evaluate(expr->left);
     Object right = evaluate(expr->right);
 
+    // Quickened, as the Compiler's closures are (see Quickening.h).
+    bool numbers = isNumber(left) && isNumber(right);
     switch (expr->bOperator.type)
     {
         case GREATER:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) > double(right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) > number(right));
         case GREATER_EQUAL:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) >= double(right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) >= number(right));
         case LESS:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) < double(right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) < number(right));
         case LESS_EQUAL:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) <= double(right));
-        case BANG_EQUAL: return Object(!isEqual(left, right));
-        case EQUAL_EQUAL: return Object(isEqual(left, right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) <= number(right));
+        case BANG_EQUAL:
+        case EQUAL_EQUAL:
+        {
+            bool equal = (expr->bOperator.type == EQUAL_EQUAL);
+            if ((expr->seen == NUMBERS) && numbers)
+                return Object((number(left) == number(right)) == equal);
+            if ((expr->seen == STRINGS) && isString(left) && isString(right))
+                return Object((text(left) == text(right)) == equal);
+
+            requicken(expr->seen, expr->misses, left, right);
+            return Object(isEqual(left, right) == equal);
+        }
         case MINUS:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) - double(right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) - number(right));
         case PLUS:
+            if ((expr->seen == NUMBERS) && numbers)
+                return Object(number(left) + number(right));
+            if ((expr->seen == STRINGS) && isString(left) && isString(right))
+                return Object(text(left) + text(right));
+
+            requicken(expr->seen, expr->misses, left, right);
             return plus(expr, left, right);
         case SLASH:
-            checkNumberOperands(expr->bOperator, left, right);
-            if (double(right) == 0)
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            if (number(right) == 0)
                 throw RuntimeError(expr->bOperator, "Division by zero not allowed.");
-            return Object(double(left) / double(right));
+            return Object(number(left) / number(right));
         case STAR:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(double(left) * double(right));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(number(left) * number(right));
         case MOD:
         {
-            checkNumberOperands(expr->bOperator, left, right);
-            if (double(right) == 0)
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            if (number(right) == 0)
                 throw RuntimeError(expr->bOperator, "Cannot compute value mod 0.");
-            double doubleLeft = double(left);
-            double doubleRight = double(right);
+            double doubleLeft = number(left);
+            double doubleRight = number(right);
             int intLeft = (int) doubleLeft;
             int intRight = (int) doubleRight;
             if (((doubleLeft - intLeft) != 0) or ((doubleRight - intRight) != 0))
@@ -369,8 +449,8 @@ Object Interpreter::visitBinaryExpr(Binary* expr)
             return Object((double)(intLeft % intRight));
         }
         case POWER:
-            checkNumberOperands(expr->bOperator, left, right);
-            return Object(pow(double(left), double(right)));
+            if (!numbers) checkNumberOperands(expr->bOperator, left, right);
+            return Object(pow(number(left), number(right)));
         default:
             return Object(nullptr);
     }
@@ -388,37 +468,37 @@ Object Interpreter::call(Object callee, std::vector<Object> arguments, Call* exp
         function = class(callee);
     else if constexpr (std::is_same_v<Func, ListFunction>)
         function = listfunc(callee);
-
-    if ((int) arguments.size() != function.arity())
-        throw RuntimeError(expr->paren, "Expected " +
-            std::to_string(function.arity()) + " arguments but got " +
-            std::to_string(arguments.size()) + ".");
-
+    else if constexpr (std::is_same_v<Func, SequenceFunction>)
+        function = seqfunc(callee);
+    else if constexpr (std::is_same_v<Func, DictFunction>)
+        function = dictfunc(callee);
+    else if constexpr (std::is_same_v<Func, ArrayFunction>)
+        function = arrayfunc(callee);
+
+    checkArity(expr, function.arity(), arguments.size());
     return function.call(*this, expr, arguments);
 }
 
 Object Interpreter::visitCallExpr(Call* expr)
 {
+    bool tail = tailPosition;
+    tailPosition = false;
     Object callee = evaluate(expr->callee);
 
     std::vector<Object> arguments;
     for (Expr* argument: expr->arguments)
         arguments.push_back(evaluate(argument));
 
-    std::vector<Type> validTypes = { LOX_FUNC, LOX_CLASS, LOX_NATIVE, LIST_FUNC };
-    if (std::find(validTypes.begin(), validTypes.end(), type(callee)) 
-            == validTypes.end())
-        throw RuntimeError(expr->paren, "Can only call functions and classes.");
-
-    if (type(callee) == LOX_FUNC)
-        return call<LoxFunction>(callee, arguments, expr);
-    if (type(callee) == LOX_CLASS)
-        return call<LoxClass>(callee, arguments, expr);
-    if (type(callee) == LOX_NATIVE)
-        return call<BuiltinFunction>(callee, arguments, expr);
-    if (type(callee) == LIST_FUNC)
-        return call<ListFunction>(callee, arguments, expr);
-    return Object(nullptr); // Unreachable.
+    if (tail && (type(callee) == LOX_FUNC))
+    {
+        LoxFunction* function = std::any_cast<LoxFunction>(&callee.value);
+        checkArity(expr, function->arity(), arguments.size());
+        tailCallee = std::move(*function);
+        tailArguments = std::move(arguments);
+        tailCalling = true;
+        return Object(nullptr);
+    }
+    return invoke(callee, arguments, expr);
 }
 
 Object Interpreter::visitCommaExpr(Comma* expr)
@@ -430,6 +510,18 @@ Object Interpreter::visitCommaExpr(Comma* expr)
     return evaluate(expressions[expressionNumber - 1]);
 }
 
+Object Interpreter::visitDictExpr(Dict* expr)
+{
+    DictObject dict;
+    for (int i = 0; i < (int) expr->keys.size(); i++)
+    {
+        Object key = evaluate(expr->keys[i]);
+        DictObject::checkKey(expr->brace, key);
+        dict.insert(key, evaluate(expr->values[i]));
+    }
+    return Object(dict);
+}
+
 Object Interpreter::visitGetExpr(Get* expr)
 {
     Object object = evaluate(expr->object);
@@ -446,6 +538,12 @@ Object Interpreter::visitGetExpr(Get* expr)
         return class(object).get(expr->name);
     if (type(object) == LIST)
         return list(object).get(expr->name);
+    if (type(object) == SEQ)
+        return sequence(object).get(expr->name);
+    if (type(object) == DICT)
+        return dict(object).get(expr->name);
+    if (type(object) == ARRAY)
+        return array(object).get(expr->name);
 
     throw RuntimeError(expr->name, "Only instances have properties.");
 }
@@ -455,18 +553,65 @@ Object Interpreter::visitGroupingExpr(Grouping* expr)
     return evaluate(expr->expression);
 }
 
+Object Interpreter::visitIndexExpr(Index* expr)
+{
+    Object object = evaluate(expr->object);
+    Object subscript = evaluate(expr->index);
+
+    if (type(object) == DICT)
+    {
+        DictObject::checkKey(expr->bracket, subscript);
+        Object* value = dict(object).find(subscript);
+        if (value == nullptr)
+            throw RuntimeError(expr->bracket, "Key not found.");
+        return *value;
+    }
+
+    int index = checkIndex(expr->bracket, subscript);
+
+    try
+    {
+        if (type(object) == LIST)
+        {
+            ListObject list = list(object);
+            list.checkIndices(index, nullptr);
+            return list[index];
+        }
+        if (type(object) == ARRAY)
+        {
+            ArrayObject array = array(object);
+            ListObject::checkBounds(array.size(), index, nullptr);
+            return Object(array.at(index));
+        }
+        if (type(object) == STR)
+        {
+            std::string text = string(object);
+            ListObject::checkBounds((int) text.size(), index, nullptr);
+            if (index < 0) index += (int) text.size();
+            return Object(text.substr(index, 1));
+        }
+    }
+    catch (std::out_of_range& error)
+    {
+        throw RuntimeError(expr->bracket, error.what());
+    }
+
+    throw RuntimeError(expr->bracket, "Only lists, strings, dictionaries and arrays can be indexed.");
+}
+
 Object Interpreter::visitLambdaExpr(Lambda* expr)
 {
     Function lambdaDeclaration(Token(), &(expr->params), expr->body);
+    lambdaDeclaration.makesClosures = expr->makesClosures;
     return Object(LoxFunction(lambdaDeclaration, environment, false));
 }
 
 Object Interpreter::visitListExpr(List* expr)
 {
-    ListObject list;
+    std::vector<Object> elements;
     for (Expr* element : expr->elements)
-        list.array.push_back(evaluate(element));
-    return Object(list);
+        elements.push_back(evaluate(element));
+    return Object(ListObject(elements));
 }
 
 Object Interpreter::visitLiteralExpr(Literal* expr)
@@ -480,11 +625,11 @@ Object Interpreter::visitLogicalExpr(Logical* expr)
 
     if (expr->lOperator.type == OR)
     {
-        if (isTruthy(left)) return left;
+        if (truthy(left)) return left;
     }
     else
     {
-        if (!isTruthy(left)) return left;
+        if (!truthy(left)) return left;
     }
 
     return evaluate(expr->right);
@@ -505,17 +650,102 @@ Object Interpreter::visitSetExpr(Set* expr)
     return value;
 }
 
+Object Interpreter::visitSetIndexExpr(SetIndex* expr)
+{
+    Object object = evaluate(expr->object);
+    Object subscript = evaluate(expr->index);
+
+    if (type(object) == DICT)
+    {
+        DictObject::checkKey(expr->bracket, subscript);
+        Object value = evaluate(expr->value);
+        dict(object).insert(subscript, value);
+        return value;
+    }
+
+    int index = checkIndex(expr->bracket, subscript);
+    if (type(object) == ARRAY)
+    {
+        Object value = evaluate(expr->value);
+        if (type(value) != NUM)
+            throw RuntimeError(expr->bracket, "Float64Array elements must be numbers.");
+        ArrayObject array = array(object);
+        try
+        {
+            ListObject::checkBounds(array.size(), index, nullptr);
+        }
+        catch (std::out_of_range& error)
+        {
+            throw RuntimeError(expr->bracket, error.what());
+        }
+        array.set(index, double(value));
+        return value;
+    }
+    if (type(object) != LIST)
+        throw RuntimeError(expr->bracket, "Only list, dictionary and array elements can be assigned.");
+
+    Object value = evaluate(expr->value);
+    ListObject list = list(object);
+    try
+    {
+        list.checkIndices(index, nullptr);
+    }
+    catch (std::out_of_range& error)
+    {
+        throw RuntimeError(expr->bracket, error.what());
+    }
+    list.set(index, value);
+    return value;
+}
+
+Object Interpreter::visitSliceExpr(Slice* expr)
+{
+    Object object = evaluate(expr->object);
+
+    int length;
+    if (type(object) == LIST)
+        length = list(object).size();
+    else if (type(object) == STR)
+        length = (int) string(object).size();
+    else
+        throw RuntimeError(expr->bracket, "Only lists and strings can be sliced.");
+
+    int start = 0;
+    int end = length;
+    if (expr->start != nullptr) start = checkIndex(expr->bracket, evaluate(expr->start));
+    if (expr->end != nullptr) end = checkIndex(expr->bracket, evaluate(expr->end));
+
+    try
+    {
+        ListObject::checkBounds(length, start, &end);
+    }
+    catch (std::out_of_range& error)
+    {
+        throw RuntimeError(expr->bracket, error.what());
+    }
+
+    // Lists hand out a view over their own storage; strings are values.
+    if (type(object) == LIST)
+        return Object(list(object).partitionList(start, end));
+
+    if (start < 0) start += length;
+    if (end < 0) end += length;
+    return Object(string(object).substr(start, end - start));
+}
+
 Object Interpreter::visitSuperExpr(Super* expr)
 {
     int distance = locals[expr];
     LoxClass superclass = class(environment->getAt(distance, expr->keyword));
-    Token dummyToken = Token(THIS, "this", Object("this"), 0, 0, "");
+    Token dummyToken = Token(THIS, "this", 0, 0);
 
     LoxInstance* object = instance(environment->getAt(distance - 1, dummyToken));
 
     if (!superclass.hasMethod(expr->method.lexeme))
-        throw RuntimeError(expr->method,
-                "Undefined property '" + expr->method.lexeme + "'.");
+    {
+        std::string name(expr->method.lexeme);
+        throw RuntimeError(expr->method, "Undefined property '" + name + "'.");
+    }
 
     LoxFunction method = superclass.findMethod(expr->method.lexeme);
 
@@ -541,10 +771,10 @@ Object Interpreter::visitUnaryExpr(Unary* expr)
     switch(expr->uOperator.type)
     {
         case BANG:
-            return Object(!isTruthy(right));
+            return Object(!truthy(right));
         case MINUS:
-            checkNumberOperand(expr->uOperator, right);
-            return Object(-double(right));
+            if (!isNumber(right)) checkNumberOperand(expr->uOperator, right);
+            return Object(-number(right));
     }
 
     return Object(nullptr); // Random return value.
@@ -557,6 +787,56 @@ Object Interpreter::visitVariableExpr(Variable* expr)
 
 // Helper methods.
 
+Object Interpreter::invoke(Object callee, std::vector<Object> arguments, Call* expr)
+{
+    if (!isCallable(callee))
+        throw RuntimeError(expr->paren, "Can only call functions and classes.");
+
+    if (type(callee) == LOX_FUNC)
+        return call<LoxFunction>(callee, arguments, expr);
+    if (type(callee) == LOX_CLASS)
+        return call<LoxClass>(callee, arguments, expr);
+    if (type(callee) == LOX_NATIVE)
+        return call<BuiltinFunction>(callee, arguments, expr);
+    if (type(callee) == LIST_FUNC)
+        return call<ListFunction>(callee, arguments, expr);
+    if (type(callee) == SEQ_FUNC)
+        return call<SequenceFunction>(callee, arguments, expr);
+    if (type(callee) == DICT_FUNC)
+        return call<DictFunction>(callee, arguments, expr);
+    if (type(callee) == ARRAY_FUNC)
+        return call<ArrayFunction>(callee, arguments, expr);
+    return Object(nullptr); // Unreachable.
+}
+
+void Interpreter::enterCall(Expr* expr)
+{
+    char top; // Marks how far down the native stack is.
+    if ((depth < maxDepth) && ((stackLimit == nullptr) || (&top > stackLimit)))
+    {
+        depth++;
+        return;
+    }
+
+    // Getters are called from a Get, everything else from a Call.
+    if (auto call = dynamic_cast<Call*>(expr))
+        throw RuntimeError(call->paren, "Stack overflow.");
+    throw RuntimeError(dynamic_cast<Get*>(expr)->name, "Stack overflow.");
+}
+
+void Interpreter::leaveCall()
+{
+    depth--;
+}
+
+bool Interpreter::isCallable(Object object)
+{
+    static const std::vector<Type> validTypes = { LOX_FUNC, LOX_CLASS, LOX_NATIVE, LIST_FUNC,
+                                                  SEQ_FUNC, DICT_FUNC, ARRAY_FUNC };
+    return (std::find(validTypes.begin(), validTypes.end(), type(object))
+            != validTypes.end());
+}
+
 Object Interpreter::lookUpVariable(Token name, Expr *expr)
 {
     if (locals.contains(expr))
@@ -564,12 +844,19 @@ Object Interpreter::lookUpVariable(Token name, Expr *expr)
         int distance = locals[expr];
         return environment->getAt(distance, name);
     }
-    else if (globals.values.contains(name.lexeme))
+    else if (globals.contains(name.lexeme))
         return globals.get(name);
     else
         return builtins.get(name);
 }
 
+int Interpreter::checkIndex(Token bracket, Object index)
+{
+    if ((type(index) != NUM) || (double(index) != (int) double(index)))
+        throw RuntimeError(bracket, "Index must be an integer.");
+    return (int) double(index);
+}
+
 void Interpreter::checkNumberOperand(Token bOperator, Object operand)
 {
     if (type(operand) == NUM) return;
@@ -577,6 +864,13 @@ void Interpreter::checkNumberOperand(Token bOperator, Object operand)
     throw RuntimeError(bOperator, "Operand must be a number.");
 }
 
+void Interpreter::checkArity(Call* expr, int arity, int count)
+{
+    if (count != arity)
+        throw RuntimeError(expr->paren, "Expected " + std::to_string(arity) +
+            " arguments but got " + std::to_string(count) + ".");
+}
+
 void Interpreter::checkNumberOperands(Token bOperator, Object left, Object right)
 {
     if ((type(left) == NUM) && (type(right) == NUM))
@@ -594,13 +888,8 @@ bool Interpreter::isTruthy(Object object)
 
 bool Interpreter::isEqual(Object a, Object b)
 {
-    if ((type(a) == NONE) &&
-        (type(b) == NONE))
-        return true;
-    
-    if (type(a) == NONE) return false;
-
-    return (a.value == b.value);
+    // Shared with hashing (see Hash.h) so both always agree.
+    return equalObjects(a, b);
 }
 
 std::string Interpreter::stringify(Object object)
@@ -625,7 +914,10 @@ std::string Interpreter::stringify(Object object)
     if (type(object) == LOX_FUNC) return func(object).toString();
     if (type(object) == LOX_CLASS) return class(object).toString();
     if (type(object) == LOX_INST) return instance(object)->toString();
-    if (type(object) == LIST) return list(object).toString(); 
+    if (type(object) == LIST) return list(object).toString(*this);
+    if (type(object) == SEQ) return sequence(object).toString(*this);
+    if (type(object) == DICT) return dict(object).toString(*this);
+    if (type(object) == ARRAY) return array(object).toString(*this);
     if (type(object) == TIME) return std::to_string(time(object));
 
     return ""; // Random return value.
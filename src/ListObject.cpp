@@ -1,15 +1,19 @@
 #include "../include/ListObject.h"
 #include "../include/Error.h"
 #include "../include/Expr.h"
+#include "../include/Hash.h"
 #include "../include/Interpreter.h"
 #include "../include/Object.h"
+#include "../include/SequenceObject.h"
 #include "../include/Token.h"
 #include "../include/Types.h"
 #include <algorithm>
 #include <any>
+#include <climits>
+#include <cmath>
 #include <functional>
+#include <memory>
 #include <stdexcept>
-#include <unordered_map>
 #include <vector>
 
 static std::string_view functions[] = {
@@ -24,79 +28,163 @@ static std::string_view functions[] = {
 
 ListObject::ListObject()
 {
-    this->array = {};
-    for (std::string_view function : functions)
-        this->methods[function] = ListFunction(function);
+    this->state = std::make_shared<ListState>();
+    this->state->buffer = std::make_shared<std::vector<Object>>();
 }
 
 ListObject::ListObject(std::vector<Object> array)
 {
-    this->array = array;
-    for (std::string_view function : functions)
-        this->methods[function] = ListFunction(function);
+    this->state = std::make_shared<ListState>();
+    this->state->buffer = std::make_shared<std::vector<Object>>(std::move(array));
 }
 
 Object ListObject::get(Token name)
 {
-    auto it = methods.find(name.lexeme);
-    if (it != methods.end())
+    // Methods come from the static table instead of a per-list map,
+    // so building a list (e.g. when collecting a sequence) stays cheap.
+    for (std::string_view function : functions)
     {
-        ListFunction method = it->second;
-        method.bind(*this);
-        return Object(method);
+        if (function == name.lexeme)
+        {
+            ListFunction method(function);
+            method.bind(*this);
+            return Object(method);
+        }
     }
 
-    throw RuntimeError(name, "Undefined property or method '" + name.lexeme + "'.");
+    throw RuntimeError(name, "Undefined property or method '" + std::string(name.lexeme) + "'.");
 }
 
-Object& ListObject::operator[](int index)
+void ListObject::set(int index, Object value)
 {
-    if (index > 0)
-        return array[index];
-    else
-        return array[(int) array.size() + index];
+    if (index < 0) index += size();
+    modify()[index] = value;
+}
+
+int ListObject::size()
+{
+    if (state->view) return (int) state->length;
+    return (int) state->buffer->size();
+}
+
+const Object& ListObject::operator[](int index)
+{
+    if (index < 0) index += size();
+    return (*state->buffer)[state->offset + index];
+}
+
+std::vector<Object>& ListObject::modify()
+{
+    state->index.reset();
+    state->lookups = 0;
+
+    if (state->view)
+    {
+        auto first = state->buffer->begin() + state->offset;
+        state->buffer = std::make_shared<std::vector<Object>>(first, first + state->length);
+        state->offset = 0;
+        state->view = false;
+    }
+    // Only views share a buffer with its owner, so leave them the old one.
+    else if (state->buffer.use_count() > 1)
+        state->buffer = std::make_shared<std::vector<Object>>(*state->buffer);
+
+    return *state->buffer;
+}
+
+int ListObject::find(Object value, bool last)
+{
+    // A one-off lookup is cheapest as a scan; index the list once
+    // it is queried again, and reuse that until it changes.
+    if ((state->index == nullptr) && (size() >= 16) && (++state->lookups >= 2))
+        buildIndex();
+
+    if (state->index != nullptr)
+        return last ? state->index->last(value) : state->index->first(value);
+
+    if (!isHashable(value)) return -1; // Equal to nothing.
+    int length = size();
+    for (int i = 0; i < length; i++)
+    {
+        int position = last ? length - 1 - i : i;
+        if (equalObjects((*this)[position], value)) return position;
+    }
+    return -1;
+}
+
+ListObject ListObject::unique()
+{
+    int length = size();
+    if (length == 0) return ListObject();
+
+    HashIndex* index = state->index.get();
+    if (index == nullptr) index = buildIndex();
+
+    // Keep the first occurrence of each value, in order.
+    std::vector<Object> elements;
+    for (int i = 0; i < length; i++)
+    {
+        const Object& element = (*this)[i];
+        if (!isHashable(element) || (index->first(element) == i))
+            elements.push_back(element);
+    }
+    return ListObject(elements);
+}
+
+HashIndex* ListObject::buildIndex()
+{
+    const Object* elements = state->buffer->data() + state->offset;
+    state->index = std::make_shared<HashIndex>(elements, size());
+    return state->index.get();
 }
 
 bool ListObject::checkIndices(int start, int *end)
 {
-    int length = (int) this->array.size();
-    if ((end == nullptr) && (start < -1*length))
-        throw std::out_of_range("Index out of bounds.");
-    else if ((end == nullptr) && (start >= length))
+    checkBounds(size(), start, end);
+    return true;
+}
+
+void ListObject::checkBounds(int length, int start, int *end)
+{
+    if ((end == nullptr) && ((start < -1*length) || (start >= length)))
         throw std::out_of_range("Index out of bounds.");
-    else if ((end != nullptr) && (start < 0))
+    else if ((end != nullptr) && ((start < -1*length) || (start > length)))
         throw std::out_of_range("Start index out of bounds.");
     else if (end != nullptr)
     {
-        if (((*end > 0) && (*end < start)) || (*end < -1*length))
+        int first = (start < 0) ? start + length : start;
+        int last = (*end < 0) ? *end + length : *end;
+        if ((*end < -1*length) || (*end > length) || (last < first))
             throw std::out_of_range("End index out of bounds.");
     }
-
-    return true;
 }
 
 ListObject ListObject::partitionList(int start, int end)
 {
-    // Starting basic implementation.
-    // Assuming end is not null.
-    std::vector<Object> partition(end - start + 1);
-    std::copy(this->array.begin() + start, this->array.begin() + end, 
-            partition.begin());
-    return ListObject(partition);
+    // Indices must already be checked (and may count from the end).
+    if (start < 0) start += size();
+    if (end < 0) end += size();
+
+    // The partition is a view over the same buffer; nothing is copied.
+    ListObject partition;
+    partition.state->buffer = this->state->buffer;
+    partition.state->offset = this->state->offset + start;
+    partition.state->length = end - start;
+    partition.state->view = true;
+    return partition;
 }
 
-std::string ListObject::toString()
+std::string ListObject::toString(Interpreter& interpreter)
 {
-    Interpreter dummyInterpreter;
     std::string string = "[";
 
-    for (int i = 0; i < (int) this->array.size(); i++)
+    for (int i = 0; i < size(); i++)
     {
-        Object element = this->array[i];
+        Object element = (*this)[i];
         if (i != 0) string += ", ";
         if (type(element) == STR)
             string += "\"";
-        string += dummyInterpreter.stringify(element);
+        string += interpreter.stringify(element);
         if (type(element) == STR)
             string += "\"";
     }
@@ -119,72 +207,110 @@ std::string ListObject::toString()
 ListFunction::ListFunction(std::string_view mode)
 {
     this->mode = mode;
-    this->instance = nullptr;
 }
 
 void ListFunction::bind(ListObject& instance)
 {
-    this->instance = &instance;
+    this->instance = instance;
 }
 
-Object ListFunction::call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments)
+Object ListFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
 {
-    // Temporary implementation.
     Call* call = (Call *) expr;
-    std::string_view calleeName = ((Variable *) call->callee)->name.lexeme;
+    check(call, arguments);
 
-    if (calleeName == "add")
+    if (mode == "add")
     {
-        add(*call, arguments[0]);
+        add(call, arguments[0]);
         return Object(nullptr);
     }
-    else if (calleeName == "insert")
+    else if (mode == "insert")
     {
-        insert(*call, double(arguments[0]), arguments[1]);
+        insert(call, double(arguments[0]), arguments[1]);
         return Object(nullptr);
     }
-    else if (calleeName == "pop")
-        return pop(*call);
-    else if (calleeName == "remove")
-        return remove(*call, double(arguments[0]));
+    else if (mode == "pop")
+        return pop(call);
+    else if (mode == "remove")
+        return remove(call, double(arguments[0]));
+    else if ((mode == "contains") || (mode == "index") || (mode == "indexLast"))
+    {
+        int position = instance.find(arguments[0], mode == "indexLast");
+        if (mode == "contains") return Object(position != -1);
+        if (position == -1) return Object(nullptr);
+        return Object((double) position);
+    }
+    else if (mode == "unique")
+        return Object(instance.unique());
+    // Everything a sequence can do, a list can do by running a stage-less sequence.
+    else if (SequenceObject::hasMethod(mode))
+        return SequenceObject(instance).apply(mode, interpreter, call, arguments);
     else
         return Object(nullptr); // Temporary.
 }
 
-void ListFunction::add(Call expr, Object element)
+void ListFunction::add(Call*, Object element)
 {
-    this->instance->array.push_back(element);
+    this->instance.modify().push_back(element);
 }
 
-void ListFunction::insert(Call expr, double index, Object element) {}
+void ListFunction::insert(Call* expr, double index, Object element)
+{
+    std::vector<Object>& array = this->instance.modify();
+    int position = (int) index;
+    if (position < 0) position += (int) array.size() + 1;
+    if ((position < 0) || (position > (int) array.size()))
+        throw RuntimeError(expr->paren, "List index out of range.");
+    array.insert(array.begin() + position, element);
+}
 
-Object ListFunction::pop(Call expr)
+Object ListFunction::pop(Call* expr)
 {
-    Object last = this->instance->array.back();
-    this->instance->array.pop_back();
+    if (this->instance.size() == 0)
+        throw RuntimeError(expr->paren, "Cannot pop from an empty list.");
+    std::vector<Object>& array = this->instance.modify();
+    Object last = array.back();
+    array.pop_back();
     return last;
 }
 
-Object ListFunction::remove(Call expr, double index)
+Object ListFunction::remove(Call* expr, double index)
 {
-    // Temporarily to suppress errors.
-    return Object(nullptr);
+    std::vector<Object>& array = this->instance.modify();
+    int position = (int) index;
+    if (position < 0) position += (int) array.size();
+    if ((position < 0) || (position >= (int) array.size()))
+        throw RuntimeError(expr->paren, "List index out of range.");
+    Object removed = array[position];
+    array.erase(array.begin() + position);
+    return removed;
 }
 
 int ListFunction::arity()
 {
+    if ((mode == "add") || (mode == "remove") || (mode == "indexLast")) return 1;
+    if (mode == "insert") return 2;
+    if ((mode == "pop") || (mode == "unique")) return 0;
+    if (SequenceObject::hasMethod(mode)) return SequenceObject::arity(mode);
     // Temporarily to suppress errors.
     return 1;
 }
 
 std::string ListFunction::toString()
 {
-    // Temporarily to suppress errors.
-    return "";
+    return "<list method " + std::string(mode) + ">";
 }
 
-bool ListFunction::check(Call expr, std::vector<Object> arguments)
+bool ListFunction::check(Call* expr, std::vector<Object> arguments)
 {
-    // Temporarily to suppress errors.
+    if ((mode == "insert") || (mode == "remove"))
+    {
+        // Checked before the cast: a double past int's range can't be cast.
+        if ((type(arguments[0]) != NUM) ||
+            (double(arguments[0]) != std::trunc(double(arguments[0]))) ||
+            (double(arguments[0]) < INT_MIN) || (double(arguments[0]) > INT_MAX))
+            throw RuntimeError(expr->paren, "List index must be an integer.");
+    }
+
     return true;
 }
\ No newline at end of file
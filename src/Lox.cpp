@@ -1,41 +1,60 @@
 #include "../include/Lox.h"
+#include "../include/AstCache.h"
+#include "../include/Compiler.h"
 // #include "../include/Cleaner.h"
 #include "../include/Error.h"
 #include "../include/Interpreter.h"
 #include "../include/Nodes.h"
-#include "../include/Parser.h"
+#include "../include/Optimizer.h"
+#include "../include/Pruner.h"
 #include "../include/Resolver.h"
-#include "../include/Scanner.h"
+#include "../include/SourceTable.h"
 #include "../include/Token.h"
 #include <cctype>
+#include <exception>
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#define OWN_STACK
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
 
 bool Lox::hadError = false;
 bool Lox::hadRuntimeError = false;
+bool Lox::wholeProgram = true;
 Interpreter Lox::interpreter = Interpreter();
 
 void Lox::runFile(char* path)
 {
-	std::ifstream fileIn(path);
-    if (fileIn.fail())
+	int file = SourceTable::load(path);
+    if (file == -1)
     {
         std::cerr << "File could not be opened.";
         exit(66);
     }
 
-	std::string source((std::istreambuf_iterator<char>(fileIn)), std::istreambuf_iterator<char>());
-	run(source, path);
+	run(file);
 
 	// Indicate an error in the exit code.
 	if (hadError) exit(65);
 	if (hadRuntimeError) exit(70);
 }
 
+bool Lox::failed()
+{
+    return hadError;
+}
+
 void Lox::runPrompt()
 {  
+    // Entries are too small to be worth caching.
+    AstCache::enabled = false;
+    // Later entries may use anything an earlier one declares.
+    wholeProgram = false;
+
     while (true)
 	{
 		std::cout << ">>> ";
@@ -61,28 +80,33 @@ void Lox::runPrompt()
 		if (line == "") break;
 
         prepString(line);
-		run(line);
+		run(SourceTable::add("_REPL_", std::move(line)));
 		hadError = false;
 	}
 }
 
-void Lox::run(std::string& source, std::string fileName)
+void Lox::run(int file)
 {	
-	Scanner scanner(source, fileName);
-	std::vector<Token> tokens = scanner.scanTokens();
-
-    if (hadError) return;
-
-    Parser parser(tokens);
-    vpS statements = parser.parse();
+    vpS statements = AstCache::parse(file);
 
 	if (hadError) return;
 
     Resolver resolver(interpreter);
     resolver.resolve(statements);
+    AstCache::commit();
 
     if (hadError) return;
 
+    Pruner pruner;
+    if (wholeProgram)
+        pruner.prune(statements);
+
+    if (Optimizer::enabled)
+    {
+        Optimizer optimizer(interpreter);
+        optimizer.optimize(statements, wholeProgram ? &pruner : nullptr);
+    }
+
     interpreter.interpret(statements);
 }
 
@@ -126,7 +150,7 @@ void Lox::error(BaseError& exception)
     else if (exception.token.type == eof)
         report(exception, " at end");
     else
-        report(exception, " at '" + exception.token.lexeme + "'");
+        report(exception, " at '" + std::string(exception.token.lexeme) + "'");
 }
 
 void Lox::report(BaseError& error, std::string where)
@@ -144,7 +168,7 @@ void Lox::report(BaseError& error, std::string where)
     
     std::string file;
     if (lexerFile != "") file = lexerFile;
-    else if (error.token.fileName != "") file = error.token.fileName;
+    else if (error.token.fileName() != "") file = error.token.fileName();
     else
         file = "_REPL_";
     
@@ -165,15 +189,94 @@ void Lox::report(BaseError& error, std::string where)
 		hadError = true;
 }
 
+static void usage()
+{
+    std::cout << "Usage: cpplox [--no-cache] [--no-optimize] [--no-compile] [--max-depth=N] [script]";
+    exit(64);
+}
+
+// Native stack set aside for each Lox call, and for everything else.
+// A call that needs more than its share is still stopped in time, as the
+// Interpreter checks the stack itself.
+static const size_t frameStack = 8 * 1024;
+static const size_t stackReserve = 1024 * 1024;
+
+static void* start(void* path)
+{
+    if (path != nullptr)
+        Lox::runFile((char*) path);
+    else
+        Lox::runPrompt();
+    return nullptr;
+}
+
+// Runs the script, or the prompt without one, on a thread whose stack is
+// big enough for Interpreter::maxDepth nested calls. The stack is only
+// reserved up front: memory is taken as calls reach into it.
+static void runDeep(char* path)
+{
+#ifdef OWN_STACK
+    size_t size = Interpreter::maxDepth * frameStack + stackReserve;
+    void* stack = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    pthread_attr_t attributes;
+    if ((stack != MAP_FAILED) && (pthread_attr_init(&attributes) == 0))
+    {
+        pthread_t thread;
+        Interpreter::stackLimit = (char*) stack + stackReserve;
+        bool started = (pthread_attr_setstack(&attributes, stack, size) == 0) &&
+                       (pthread_create(&thread, &attributes, start, path) == 0);
+        pthread_attr_destroy(&attributes);
+        if (started)
+        {
+            pthread_join(thread, nullptr);
+            return;
+        }
+    }
+
+    // No thread: stay within the stack of this one.
+    char base;
+    struct rlimit limit;
+    if ((getrlimit(RLIMIT_STACK, &limit) == 0) && (limit.rlim_cur != RLIM_INFINITY) &&
+        (limit.rlim_cur > 2 * stackReserve))
+        Interpreter::stackLimit = &base - (limit.rlim_cur - stackReserve);
+#endif
+    start(path);
+}
+
 int main(int argc, char **argv)
 {
-	if (argc > 2)
-	{
-		std::cout << "Usage: cpplox [script]";
-		exit(64);
-	}
-	else if (argc == 2)
-		Lox::runFile(argv[1]);
+    // Options come before the script.
+    int arg = 1;
+    for (; (arg < argc) && (argv[arg][0] == '-') && (argv[arg][1] == '-'); arg++)
+    {
+        std::string option = argv[arg];
+        if (option == "--no-cache")
+            AstCache::enabled = false;
+        else if (option == "--no-optimize")
+            Optimizer::enabled = false;
+        else if (option == "--no-compile")
+            Compiler::enabled = false;
+        else if (option.starts_with("--max-depth="))
+        {
+            try
+            {
+                Interpreter::maxDepth = std::stoi(option.substr(12));
+            }
+            catch (std::exception&)
+            {
+                usage();
+            }
+            if (Interpreter::maxDepth < 1) usage();
+        }
+        else
+            usage();
+    }
+
+	if (argc - arg > 1)
+		usage();
+	else if (argc - arg == 1)
+		runDeep(argv[arg]);
 	else
-		Lox::runPrompt();
+		runDeep(nullptr);
 }
\ No newline at end of file
@@ -7,15 +7,16 @@
 #include <string>
 
 LoxClass::LoxClass(std::string name, LoxClass* metaclass,
-    LoxClass* superclass, std::map<std::string, LoxFunction> methods) :
+    LoxClass* superclass, std::map<std::string, LoxFunction, std::less<>> methods) :
         ClassInstance(Object(metaclass))
 {
     this->name = name;
     this->superclass = superclass;
+    this->metaclass = metaclass;
     this->methods = methods;
 }
 
-bool LoxClass::hasMethod(std::string name)
+bool LoxClass::hasMethod(std::string_view name)
 {
     if (methods.contains(name)) return true;
 
@@ -25,10 +26,11 @@ bool LoxClass::hasMethod(std::string name)
     return false;
 }
 
-LoxFunction LoxClass::findMethod(std::string name)
+LoxFunction LoxClass::findMethod(std::string_view name)
 {
-    if (methods.contains(name))
-        return methods[name];
+    auto method = methods.find(name);
+    if (method != methods.end())
+        return method->second;
 
     return superclass->findMethod(name);
 }
@@ -38,7 +40,7 @@ std::string LoxClass::toString()
     return "<class " + name + ">";
 }
 
-Object LoxClass::call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments)
+Object LoxClass::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
 {
     LoxInstance* ptr = new LoxInstance(*this);
     if (hasMethod("init"))
@@ -6,8 +6,10 @@
 #include "../include/Interpreter.h"
 #include "../include/LoxInstance.h"
 #include "../include/Object.h"
+#include "../include/Parser.h"
 #include "../include/Stmt.h"
 #include <string>
+#include <utility>
 #include <vector>
 
 #define VAR_DEC true
@@ -34,34 +36,87 @@ LoxFunction LoxFunction::bind(ClassInstance* instance)
     return LoxFunction(declaration, environment, isInitializer);
 }
 
-Object LoxFunction::call(Interpreter interpreter, Expr* expr, std::vector<Object> arguments)
+Object LoxFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
 {
-    (void) expr; // To silence error.
-    
-    Environment environment = new Environment(closure);
-    if (declaration.params != nullptr)
+    interpreter.enterCall(expr);
+
+    // Calls in tail position come back here to be made in turn.
+    LoxFunction* function = this;
+    LoxFunction next;
+    while (true)
     {
-        vT params = *declaration.params;
-        for (int i = 0; i < (int) declaration.params->size(); i++)
-            environment.define(params[i].lexeme, arguments[i], VAR_DEC);
+        Object result;
+        try
+        {
+            result = function->run(interpreter, arguments);
+        }
+        catch (...)
+        {
+            interpreter.leaveCall();
+            throw;
+        }
+        if (!interpreter.tailCalling)
+        {
+            interpreter.leaveCall();
+            return result;
+        }
+
+        interpreter.tailCalling = false;
+        next = std::move(interpreter.tailCallee);
+        arguments = std::move(interpreter.tailArguments);
+        function = &next;
     }
+}
 
-    //Edit to match my getAt code.
-    Token dummyToken = Token(THIS, "this", Object(nullptr), 0, 0, "");
+Object LoxFunction::run(Interpreter& interpreter, std::vector<Object>& arguments)
+{
+    if ((declaration.lazy != nullptr) && !declaration.lazy->compiled)
+        Parser::compile(*declaration.lazy);
+
+    // On the stack, unless functions declared in the call close over it
+    // and may be returned from it. On the heap it encloses a copy of the
+    // closure, as this function may go before them.
+    bool makesClosures = (declaration.lazy != nullptr) ?
+        declaration.lazy->makesClosures : declaration.makesClosures;
+    Environment local(&closure);
+    Environment* environment = &local;
+    if (makesClosures) environment = new Environment(new Environment(closure));
 
-    try
+    if (declaration.params != nullptr)
     {
-        interpreter.executeBlock(declaration.body, environment);
+        vT& params = *declaration.params;
+        for (int i = 0; i < (int) params.size(); i++)
+            environment->define(params[i].lexeme, arguments[i], VAR_DEC);
     }
-    catch (ReturnValue& returnValue)
-    {
-        if (isInitializer) return closure.getAt(0, dummyToken);
 
-        return returnValue.value;
+    if (declaration.lazy != nullptr)
+        interpreter.executeBlock(declaration.lazy->statements, *environment);
+    else
+        interpreter.executeBlock(declaration.body, *environment);
+
+    // Whatever a return statement left.
+    Object result(nullptr);
+    if (interpreter.returning)
+    {
+        interpreter.returning = false;
+        result = std::move(interpreter.returned);
     }
 
+    //Edit to match my getAt code.
+    Token dummyToken = Token(THIS, "this", 0, 0);
     if (isInitializer) return closure.getAt(0, dummyToken);
-    return Object(nullptr);
+    return result;
+}
+
+// Whether the two are the same function: made from one declaration, over
+// one environment. Environments that functions close over are never
+// freed, so their addresses are not reused. Getters share a null
+// parameter list, so they never match.
+bool LoxFunction::sameAs(LoxFunction& other)
+{
+    return (declaration.params != nullptr) &&
+           (declaration.params == other.declaration.params) &&
+           (closure.enclosing == other.closure.enclosing);
 }
 
 bool LoxFunction::isGetter()
@@ -77,5 +132,5 @@ int LoxFunction::arity()
 
 std::string LoxFunction::toString()
 {
-    return "<fn " + declaration.name.lexeme + ">";
+    return "<fn " + std::string(declaration.name.lexeme) + ">";
 }
\ No newline at end of file
@@ -13,8 +13,9 @@ LoxInstance::LoxInstance(const LoxClass& klass) :
 
 Object LoxInstance::get(Token name)
 {
-    if (fields.contains(name.lexeme))
-        return fields[name.lexeme];
+    auto field = fields.find(name.lexeme);
+    if (field != fields.end())
+        return field->second;
 
     if (klass.hasMethod(name.lexeme))
     {
@@ -22,12 +23,16 @@ Object LoxInstance::get(Token name)
         return Object(method.bind(this));
     }
 
-    throw RuntimeError(name, "Undefined property '" + name.lexeme + "'.");
+    throw RuntimeError(name, "Undefined property '" + std::string(name.lexeme) + "'.");
 }
 
 void LoxInstance::set(Token name, Object value)
 {
-    fields[name.lexeme] = value;
+    auto field = fields.find(name.lexeme);
+    if (field != fields.end())
+        field->second = value;
+    else
+        fields.emplace(name.lexeme, value);
 }
 
 std::string LoxInstance::toString()
@@ -42,6 +42,12 @@ std::string Object::printType()
         return "<class instance>";
     if (type(*this) == LIST)
         return "<list>";
+    if (type(*this) == SEQ)
+        return "<sequence>";
+    if (type(*this) == DICT)
+        return "<dictionary>";
+    if (type(*this) == ARRAY)
+        return "<Float64Array>";
     if (type(*this) == TIME)
         return "<time>";
     if (type(*this) == NONE)
@@ -0,0 +1,730 @@
+#include "../include/Optimizer.h"
+#include "../include/Error.h"
+#include "../include/Expr.h"
+#include "../include/Interpreter.h"
+#include "../include/Nodes.h"
+#include "../include/Object.h"
+#include "../include/Parser.h"
+#include "../include/Pruner.h"
+#include "../include/Scanner.h"
+#include "../include/Stmt.h"
+#include "../include/Token.h"
+#include "../include/TokenType.h"
+#include <map>
+#include <optional>
+#include <set>
+#include <string_view>
+
+#define FIX_DEC false
+
+bool Optimizer::enabled = true;
+
+// Counts the declarations that can end up in the global scope: those at
+// the top of the script and of the files it imports from there, blocks
+// aside.
+static void countGlobals(const vpS& statements, std::map<std::string_view, int>& declared,
+                         std::set<Module*>& seen)
+{
+    for (Stmt* stmt : statements)
+    {
+        if (auto var = dynamic_cast<Var*>(stmt))
+            declared[var->name.lexeme]++;
+        else if (auto function = dynamic_cast<Function*>(stmt))
+            declared[function->name.lexeme]++;
+        else if (auto klass = dynamic_cast<Class*>(stmt))
+            declared[klass->name.lexeme]++;
+        else if (auto fetch = dynamic_cast<Fetch*>(stmt))
+        {
+            if ((fetch->module != nullptr) && seen.insert(fetch->module).second)
+                countGlobals(fetch->module->statements, declared, seen);
+        }
+        else if (auto branch = dynamic_cast<If*>(stmt))
+        {
+            countGlobals({branch->thenBranch}, declared, seen);
+            if (branch->elseBranch != nullptr)
+                countGlobals({branch->elseBranch}, declared, seen);
+        }
+        else if (auto loop = dynamic_cast<While*>(stmt))
+            countGlobals({loop->body}, declared, seen);
+    }
+}
+
+// An expression statement prints its value unless it is a call (which
+// prints only a value) or an assignment (which prints nothing).
+static int printing(Expr* expr)
+{
+    if (dynamic_cast<Call*>(expr)) return 1;
+    if (dynamic_cast<Assign*>(expr) || dynamic_cast<Set*>(expr) ||
+        dynamic_cast<SetIndex*>(expr))
+        return 2;
+    return 0;
+}
+
+// Constructor.
+
+Optimizer::Optimizer(Interpreter& interpreter)
+{
+    this->interpreter = &interpreter;
+}
+
+// General methods.
+
+void Optimizer::optimize(vpS& statements, const Pruner* program)
+{
+    if (program != nullptr)
+        findGlobals(statements, *program);
+    optimizeList(statements, true);
+}
+
+void Optimizer::findGlobals(const vpS& script, const Pruner& program)
+{
+    std::map<std::string_view, int> declared;
+    std::set<Module*> seen;
+    countGlobals(script, declared, seen);
+
+    for (Stmt* stmt : script)
+    {
+        auto var = dynamic_cast<Var*>(stmt);
+        if ((var != nullptr) && (var->access == FIX_DEC) && (declared[var->name.lexeme] == 1))
+            globalConstants.insert(stmt);
+
+        // A file imported later could assign to any global.
+        auto function = dynamic_cast<Function*>(stmt);
+        if ((function != nullptr) && (declared[function->name.lexeme] == 1) &&
+            !program.rebinds(function->name.lexeme) && !program.importsLater())
+            globalFunctions.insert(stmt);
+    }
+}
+
+void Optimizer::declare(std::string_view name, std::optional<Object> value)
+{
+    if (scopes.size() == 0) return;
+    scopes[scopes.size() - 1].insert_or_assign(name, value);
+}
+
+bool Optimizer::isLocal(std::string_view name)
+{
+    for (auto& scope : scopes)
+    {
+        if (scope.contains(name)) return true;
+    }
+    return false;
+}
+
+// Declares, as not constant, every name a statement will declare in the
+// current scope. A variable is looked up through the environments that
+// enclose it when it is read, and a closure may be called after its
+// enclosing scopes have declared more names: so a constant further out
+// can only be relied on if no scope in between ever has its name.
+void Optimizer::predeclare(Stmt* stmt, std::set<Module*>& seen)
+{
+    if (auto var = dynamic_cast<Var*>(stmt))
+        declare(var->name.lexeme);
+    else if (auto function = dynamic_cast<Function*>(stmt))
+    {
+        if (function->name.line != 0) declare(function->name.lexeme);
+    }
+    else if (auto klass = dynamic_cast<Class*>(stmt))
+        declare(klass->name.lexeme);
+    else if (auto fetch = dynamic_cast<Fetch*>(stmt))
+    {
+        if ((fetch->module != nullptr) && seen.insert(fetch->module).second)
+        {
+            for (Stmt* statement : fetch->module->statements)
+                predeclare(statement, seen);
+        }
+    }
+    else if (auto branch = dynamic_cast<If*>(stmt))
+    {
+        if (!dynamic_cast<Block*>(branch->thenBranch))
+            predeclare(branch->thenBranch, seen);
+        if ((branch->elseBranch != nullptr) && !dynamic_cast<Block*>(branch->elseBranch))
+            predeclare(branch->elseBranch, seen);
+    }
+    else if (auto loop = dynamic_cast<While*>(stmt))
+    {
+        if (!dynamic_cast<Block*>(loop->body))
+            predeclare(loop->body, seen);
+    }
+}
+
+// Trimming stops after a return, break or continue. It is off for the
+// body of a loop: a 'continue' in a for-loop runs the last statement of
+// the body as the increment, so that statement must stay where it is.
+void Optimizer::optimizeList(vpS& statements, bool trim)
+{
+    std::set<Module*> seen;
+    for (Stmt* stmt : statements)
+        predeclare(stmt, seen);
+
+    vpS kept;
+    for (Stmt* stmt : statements)
+    {
+        Stmt* result = optimize(stmt);
+        if (result == nullptr)
+        {
+            if (!trim) kept.push_back(new Block(vpS()));
+            continue;
+        }
+
+        kept.push_back(result);
+        if (trim && (dynamic_cast<Return*>(result) || dynamic_cast<Break*>(result) ||
+                     dynamic_cast<Continue*>(result)))
+            break;
+    }
+    statements = kept;
+}
+
+void Optimizer::optimizeBody(Function* function)
+{
+    scopes.push_back({});
+    if (function->params != nullptr)
+    {
+        for (Token param : *(function->params))
+            declare(param.lexeme);
+    }
+
+    if (function->lazy == nullptr)
+        optimizeList(function->body, true);
+    else if (function->lazy->compiled)
+        optimizeList(function->lazy->statements, true);
+    else
+    {
+        // Optimized after it is compiled, as if it were still here.
+        function->lazy->optimize = [interpreter = interpreter, scopes = scopes,
+                                    globals = globals, inlinable = inlinable](vpS& body)
+        {
+            Optimizer optimizer(*interpreter);
+            optimizer.scopes = scopes;
+            optimizer.globals = globals;
+            optimizer.inlinable = inlinable;
+            optimizer.optimizeList(body, true);
+        };
+    }
+    scopes.pop_back();
+}
+
+Stmt* Optimizer::optimize(Stmt* stmt)
+{
+    replaced = false;
+    stmt->accept(*this);
+    Stmt* result = replaced ? statement : stmt;
+    replaced = false;
+    return result;
+}
+
+Expr* Optimizer::optimize(Expr* expr)
+{
+    expression = nullptr;
+    expr->accept(*this);
+    Expr* result = (expression != nullptr) ? expression : expr;
+    expression = nullptr;
+    return result;
+}
+
+// Evaluates an operation on literals now. One that fails is kept, to
+// fail when it is run.
+Expr* Optimizer::fold(Expr* expr)
+{
+    try
+    {
+        return new Literal(interpreter->evaluate(expr));
+    }
+    catch (RuntimeError& error)
+    {
+        (void) error;
+        return expr;
+    }
+}
+
+// Whether a body is just 'return <expression>;', with an expression made
+// of at most a few operators, literals and variables. Looked at as tokens
+// so that nothing is parsed (and no error is found early) otherwise.
+static bool isSmallLeaf(const LazyBody& lazy)
+{
+    Scanner scanner(lazy.file, lazy.begin, lazy.end, lazy.line, lazy.column);
+    if (scanner.next().type != RETURN) return false;
+
+    TokenType before = RETURN;
+    int length = 0;
+    for (Token token = scanner.next(); token.type != SEMICOLON; token = scanner.next())
+    {
+        if (++length > 24) return false;
+        switch (token.type)
+        {
+            case LEFT_PAREN:
+                // A call rather than a grouping.
+                if ((before == IDENTIFIER) || (before == RIGHT_PAREN) || (before == STRING))
+                    return false;
+                break;
+            case IDENTIFIER: case NUMBER: case STRING: case TRUE: case FALSE: case NIL:
+            case RIGHT_PAREN: case PLUS: case MINUS: case STAR: case SLASH: case MOD:
+            case POWER: case BANG: case BANG_EQUAL: case EQUAL_EQUAL: case GREATER:
+            case GREATER_EQUAL: case LESS: case LESS_EQUAL: case AND: case OR:
+            case Q_MARK: case COLON:
+                break;
+            default:
+                return false;
+        }
+        before = token.type;
+    }
+    return (scanner.next().type == RIGHT_BRACE) && (scanner.next().type == eof);
+}
+
+// Whether an expression reads nothing but the parameters. Another name
+// would be looked up from wherever the body ends up.
+static bool isLeaf(Expr* expr, const vT& params)
+{
+    if (dynamic_cast<Literal*>(expr))
+        return true;
+    if (auto variable = dynamic_cast<Variable*>(expr))
+    {
+        for (const Token& param : params)
+        {
+            if (param.lexeme == variable->name.lexeme) return true;
+        }
+        return false;
+    }
+    if (auto grouping = dynamic_cast<Grouping*>(expr))
+        return isLeaf(grouping->expression, params);
+    if (auto unary = dynamic_cast<Unary*>(expr))
+        return isLeaf(unary->right, params);
+    if (auto binary = dynamic_cast<Binary*>(expr))
+        return isLeaf(binary->left, params) && isLeaf(binary->right, params);
+    if (auto logical = dynamic_cast<Logical*>(expr))
+        return isLeaf(logical->left, params) && isLeaf(logical->right, params);
+    if (auto ternary = dynamic_cast<Ternary*>(expr))
+        return isLeaf(ternary->condition, params) && isLeaf(ternary->trueBranch, params) &&
+               isLeaf(ternary->falseBranch, params);
+    return false;
+}
+
+// The part of an expression evaluated first.
+static Expr* firstEvaluated(Expr* expr)
+{
+    if (auto grouping = dynamic_cast<Grouping*>(expr))
+        return firstEvaluated(grouping->expression);
+    if (auto unary = dynamic_cast<Unary*>(expr))
+        return firstEvaluated(unary->right);
+    if (auto binary = dynamic_cast<Binary*>(expr))
+        return firstEvaluated(binary->left);
+    if (auto logical = dynamic_cast<Logical*>(expr))
+        return firstEvaluated(logical->left);
+    if (auto ternary = dynamic_cast<Ternary*>(expr))
+        return firstEvaluated(ternary->condition);
+    return expr;
+}
+
+// The returned expression of a function that can be inlined, compiling
+// the body first if it looks small enough.
+Expr* Optimizer::inlineBody(Function* function)
+{
+    LazyBody* lazy = function->lazy;
+    if ((lazy == nullptr) || (function->params == nullptr)) return nullptr;
+    if (!lazy->compiled && (!isSmallLeaf(*lazy) || !Parser::precompile(*lazy)))
+        return nullptr;
+
+    if (lazy->statements.size() != 1) return nullptr;
+    auto returned = dynamic_cast<Return*>(lazy->statements[0]);
+    if ((returned == nullptr) || (returned->value == nullptr) ||
+        !isLeaf(returned->value, *function->params))
+        return nullptr;
+    return returned->value;
+}
+
+// A copy of an inlined body with the arguments in place of the
+// parameters, folded again.
+Expr* Optimizer::substitute(Expr* body, const vT& params, const vpE& arguments)
+{
+    if (auto variable = dynamic_cast<Variable*>(body))
+    {
+        for (int i = 0; i < (int) params.size(); i++)
+        {
+            if (params[i].lexeme == variable->name.lexeme)
+                return arguments[i];
+        }
+        return body; // Unreachable: only parameters are read.
+    }
+    if (auto grouping = dynamic_cast<Grouping*>(body))
+        return substitute(grouping->expression, params, arguments);
+    if (auto unary = dynamic_cast<Unary*>(body))
+    {
+        Expr* copy = new Unary(unary->uOperator, substitute(unary->right, params, arguments));
+        return dynamic_cast<Literal*>(dynamic_cast<Unary*>(copy)->right) ? fold(copy) : copy;
+    }
+    if (auto binary = dynamic_cast<Binary*>(body))
+    {
+        Expr* left = substitute(binary->left, params, arguments);
+        Expr* right = substitute(binary->right, params, arguments);
+        Expr* copy = new Binary(left, binary->bOperator, right);
+        return (dynamic_cast<Literal*>(left) && dynamic_cast<Literal*>(right)) ? fold(copy) : copy;
+    }
+    if (auto logical = dynamic_cast<Logical*>(body))
+    {
+        Expr* left = substitute(logical->left, params, arguments);
+        if (auto literal = dynamic_cast<Literal*>(left))
+        {
+            bool truthy = interpreter->isTruthy(literal->value);
+            if ((logical->lOperator.type == OR) ? truthy : !truthy)
+                return left;
+            return substitute(logical->right, params, arguments);
+        }
+        return new Logical(left, logical->lOperator, substitute(logical->right, params, arguments));
+    }
+    if (auto ternary = dynamic_cast<Ternary*>(body))
+    {
+        Expr* condition = substitute(ternary->condition, params, arguments);
+        if (auto literal = dynamic_cast<Literal*>(condition))
+        {
+            return substitute(interpreter->isTruthy(literal->value) ? ternary->trueBranch
+                                                                    : ternary->falseBranch,
+                              params, arguments);
+        }
+        return new Ternary(condition, substitute(ternary->trueBranch, params, arguments),
+                           substitute(ternary->falseBranch, params, arguments));
+    }
+    return body; // A literal.
+}
+
+// Statement methods.
+
+void Optimizer::visitBreakStmt(Break* stmt)
+{
+    (void) stmt;
+}
+
+void Optimizer::visitBlockStmt(Block* stmt)
+{
+    scopes.push_back({});
+    optimizeList(stmt->statements, true);
+    scopes.pop_back();
+}
+
+void Optimizer::visitClassStmt(Class* stmt)
+{
+    declare(stmt->name.lexeme);
+    for (Stmt* method : stmt->methods)
+        optimizeBody(dynamic_cast<Function*>(method));
+    for (Stmt* method : stmt->classMethods)
+        optimizeBody(dynamic_cast<Function*>(method));
+}
+
+void Optimizer::visitContinueStmt(Continue* stmt)
+{
+    (void) stmt;
+}
+
+void Optimizer::visitExpressionStmt(Expression* stmt)
+{
+    Expr* result = optimize(stmt->expression);
+    // Keep what gets printed: '(f());' prints nil, 'f();' doesn't.
+    if (printing(stmt->expression) == 1)
+        result = stmt->expression;
+    else if (printing(result) != printing(stmt->expression))
+        result = new Grouping(result);
+    stmt->expression = result;
+}
+
+void Optimizer::visitFetchStmt(Fetch* stmt)
+{
+    if (stmt->module == nullptr) return;
+
+    if (!stmt->module->optimized)
+    {
+        // In a scope of its own, as it runs in one.
+        stmt->module->optimized = true;
+        std::vector<std::map<std::string_view, std::optional<Object>>> enclosing;
+        enclosing.swap(scopes);
+        scopes.push_back({});
+        optimizeList(stmt->module->statements, true);
+        scopes.swap(enclosing);
+    }
+}
+
+void Optimizer::visitFunctionStmt(Function* stmt)
+{
+    if (stmt->name.line != 0)
+        declare(stmt->name.lexeme);
+    optimizeBody(stmt);
+    // Calls from here on may be inlined.
+    if ((scopes.size() == 0) && globalFunctions.contains(stmt))
+        inlinable.insert_or_assign(stmt->name.lexeme, stmt);
+}
+
+void Optimizer::visitIfStmt(If* stmt)
+{
+    stmt->condition = optimize(stmt->condition);
+
+    // Only the branch that is taken is left.
+    if (auto literal = dynamic_cast<Literal*>(stmt->condition))
+    {
+        Stmt* branch = interpreter->isTruthy(literal->value) ? stmt->thenBranch : stmt->elseBranch;
+        if (branch != nullptr)
+            branch = optimize(branch);
+        statement = branch;
+        replaced = true;
+        return;
+    }
+
+    Stmt* thenBranch = optimize(stmt->thenBranch);
+    stmt->thenBranch = (thenBranch != nullptr) ? thenBranch : new Block(vpS());
+    if (stmt->elseBranch != nullptr)
+        stmt->elseBranch = optimize(stmt->elseBranch);
+}
+
+void Optimizer::visitPrintStmt(Print* stmt)
+{
+    stmt->expression = optimize(stmt->expression);
+}
+
+void Optimizer::visitReturnStmt(Return* stmt)
+{
+    if (stmt->value != nullptr)
+        stmt->value = optimize(stmt->value);
+}
+
+void Optimizer::visitVarStmt(Var* stmt)
+{
+    if (stmt->initializer != nullptr)
+        stmt->initializer = optimize(stmt->initializer);
+
+    auto literal = dynamic_cast<Literal*>(stmt->initializer);
+    bool constant = (literal != nullptr) && (stmt->access == FIX_DEC);
+    if (scopes.size() == 0)
+    {
+        if (constant && globalConstants.contains(stmt))
+            globals.insert_or_assign(stmt->name.lexeme, literal->value);
+    }
+    else if (constant)
+        declare(stmt->name.lexeme, literal->value);
+    else
+        declare(stmt->name.lexeme);
+}
+
+void Optimizer::visitWhileStmt(While* stmt)
+{
+    stmt->condition = optimize(stmt->condition);
+
+    if (auto body = dynamic_cast<Block*>(stmt->body))
+    {
+        scopes.push_back({});
+        optimizeList(body->statements, false);
+        scopes.pop_back();
+        return;
+    }
+    Stmt* body = optimize(stmt->body);
+    stmt->body = (body != nullptr) ? body : new Block(vpS());
+}
+
+// Expression methods.
+
+Object Optimizer::visitAssignExpr(Assign* expr)
+{
+    expr->value = optimize(expr->value);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitBinaryExpr(Binary* expr)
+{
+    expr->left = optimize(expr->left);
+    expr->right = optimize(expr->right);
+    if (dynamic_cast<Literal*>(expr->left) && dynamic_cast<Literal*>(expr->right))
+        expression = fold(expr);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitCallExpr(Call* expr)
+{
+    expr->callee = optimize(expr->callee);
+    for (Expr*& argument : expr->arguments)
+        argument = optimize(argument);
+
+    auto callee = dynamic_cast<Variable*>(expr->callee);
+    if ((callee == nullptr) || isLocal(callee->name.lexeme)) return Object(nullptr);
+    auto found = inlinable.find(callee->name.lexeme);
+    if (found == inlinable.end()) return Object(nullptr);
+    Function* function = found->second;
+    Expr* body = inlineBody(function);
+    if ((body == nullptr) || (function->params->size() != expr->arguments.size()))
+        return Object(nullptr);
+
+    // Arguments are only literals and variables, which can be read again
+    // with no effect. A variable is still read before the body is run,
+    // as a call would, unless the body starts by reading it anyway.
+    vpE reads;
+    for (Expr* argument : expr->arguments)
+    {
+        if (dynamic_cast<Variable*>(argument))
+            reads.push_back(argument);
+        else if (!dynamic_cast<Literal*>(argument))
+            return Object(nullptr);
+    }
+    if (reads.size() == 1)
+    {
+        auto first = dynamic_cast<Variable*>(firstEvaluated(body));
+        for (int i = 0; i < (int) expr->arguments.size(); i++)
+        {
+            if ((first != nullptr) && (expr->arguments[i] == reads[0]) &&
+                ((*function->params)[i].lexeme == first->name.lexeme))
+                reads.clear();
+        }
+    }
+
+    Expr* inlined = substitute(body, *function->params, expr->arguments);
+    if (reads.empty())
+        expression = inlined;
+    else
+    {
+        reads.push_back(inlined);
+        expression = new Comma(reads);
+    }
+    return Object(nullptr);
+}
+
+Object Optimizer::visitCommaExpr(Comma* expr)
+{
+    for (Expr*& expression : expr->expressions)
+        expression = optimize(expression);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitDictExpr(Dict* expr)
+{
+    for (int i = 0; i < (int) expr->keys.size(); i++)
+    {
+        expr->keys[i] = optimize(expr->keys[i]);
+        expr->values[i] = optimize(expr->values[i]);
+    }
+    return Object(nullptr);
+}
+
+Object Optimizer::visitGetExpr(Get* expr)
+{
+    expr->object = optimize(expr->object);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitGroupingExpr(Grouping* expr)
+{
+    expression = optimize(expr->expression);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitIndexExpr(Index* expr)
+{
+    expr->object = optimize(expr->object);
+    expr->index = optimize(expr->index);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitLambdaExpr(Lambda* expr)
+{
+    scopes.push_back({});
+    for (Token param : expr->params)
+        declare(param.lexeme);
+    optimizeList(expr->body, true);
+    scopes.pop_back();
+    return Object(nullptr);
+}
+
+Object Optimizer::visitListExpr(List* expr)
+{
+    for (Expr*& element : expr->elements)
+        element = optimize(element);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitLiteralExpr(Literal* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Optimizer::visitLogicalExpr(Logical* expr)
+{
+    expr->left = optimize(expr->left);
+    expr->right = optimize(expr->right);
+
+    // The left operand is the result if it decides, else the right one is.
+    if (auto literal = dynamic_cast<Literal*>(expr->left))
+    {
+        bool truthy = interpreter->isTruthy(literal->value);
+        bool decides = (expr->lOperator.type == OR) ? truthy : !truthy;
+        expression = decides ? expr->left : expr->right;
+    }
+    return Object(nullptr);
+}
+
+Object Optimizer::visitSetExpr(Set* expr)
+{
+    expr->value = optimize(expr->value);
+    expr->object = optimize(expr->object);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitSetIndexExpr(SetIndex* expr)
+{
+    expr->value = optimize(expr->value);
+    expr->object = optimize(expr->object);
+    expr->index = optimize(expr->index);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitSliceExpr(Slice* expr)
+{
+    expr->object = optimize(expr->object);
+    if (expr->start != nullptr) expr->start = optimize(expr->start);
+    if (expr->end != nullptr) expr->end = optimize(expr->end);
+    return Object(nullptr);
+}
+
+Object Optimizer::visitSuperExpr(Super* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Optimizer::visitTernaryExpr(Ternary* expr)
+{
+    expr->condition = optimize(expr->condition);
+    expr->trueBranch = optimize(expr->trueBranch);
+    expr->falseBranch = optimize(expr->falseBranch);
+
+    if (auto literal = dynamic_cast<Literal*>(expr->condition))
+        expression = interpreter->isTruthy(literal->value) ? expr->trueBranch : expr->falseBranch;
+    return Object(nullptr);
+}
+
+Object Optimizer::visitThisExpr(This* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Optimizer::visitUnaryExpr(Unary* expr)
+{
+    expr->right = optimize(expr->right);
+    if (dynamic_cast<Literal*>(expr->right))
+        expression = fold(expr);
+    return Object(nullptr);
+}
+
+// Reads of a constant become its value.
+Object Optimizer::visitVariableExpr(Variable* expr)
+{
+    for (int i = scopes.size() - 1; i >= 0; i--)
+    {
+        auto found = scopes[i].find(expr->name.lexeme);
+        if (found != scopes[i].end())
+        {
+            if (found->second.has_value())
+                expression = new Literal(*found->second);
+            return Object(nullptr);
+        }
+    }
+
+    auto global = globals.find(expr->name.lexeme);
+    if (global != globals.end())
+        expression = new Literal(global->second);
+    return Object(nullptr);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../include/Overloads.h"
+#include "../include/Classes.h"
 #include "../include/Nodes.h"
 #include <any>
 #include <string>
@@ -17,6 +18,9 @@ bool operator==(const std::any& A, const std::any& B)
         return (bool(A) == bool(B));
     else if (A.type() == typeid(std::string))
         return (string(A) == string(B));
+    // Instances are equal only to themselves.
+    else if (A.type() == typeid(LoxInstance *))
+        return (std::any_cast<LoxInstance *>(A) == std::any_cast<LoxInstance *>(B));
     
     return false; // Random return value.
 }
@@ -1,16 +1,20 @@
 #include "../include/Parser.h"
+#include "../include/AstCache.h"
 #include "../include/Error.h"
 #include "../include/Expr.h"
 #include "../include/Lox.h"
 #include "../include/Nodes.h"
 #include "../include/Scanner.h"
+#include "../include/SourceTable.h"
 #include "../include/Stmt.h"
 #include "../include/Token.h"
 #include "../include/TokenType.h"
+#include <array>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -19,9 +23,30 @@ namespace fs = std::filesystem;
 #define FIX_DEC false
 
 // Public methods.
-Parser::Parser(vT tokens)
+// Imported files by canonical path, with the modification time they had
+// when parsed. They are kept for the whole process.
+struct CachedModule
 {
-    this->tokens = tokens;
+    fs::file_time_type modified;
+    Module* module;
+};
+
+static std::map<std::string, CachedModule> modules;
+
+int Parser::warnings = 0;
+
+Parser::Parser(int file) : scanner(file)
+{
+    this->file = file;
+    this->currentToken = scanner.next();
+}
+
+Parser::Parser(const LazyBody& lazy) :
+    scanner(lazy.file, lazy.begin, lazy.end, lazy.line, lazy.column)
+{
+    this->file = lazy.file;
+    this->loopType = lazy.loopType;
+    this->currentToken = scanner.next();
 }
 
 vpS Parser::parse()
@@ -35,8 +60,10 @@ vpS Parser::parse()
         }
         catch (ParseError& error)
         {
-            synchronize();
-            error.show();
+            // Scan the rest so every scan error gets reported. A parse
+            // error after one of those is only a knock-on, so it is dropped.
+            while (!isAtEnd()) advance();
+            if (!Lox::failed()) error.show();
             return {};
         }
     }
@@ -121,43 +148,57 @@ Stmt* Parser::continueStatement()
 Stmt* Parser::fetchStatement()
 {
     Token modeToken = previous();
-    std::string mode = modeToken.lexeme;
+    std::string mode(modeToken.lexeme);
     mode = mode.substr(3, mode.length() - 3);
     Token nameToken = consume(STRING, "Expect name of import.");
-    std::string name = nameToken.lexeme;
+    std::string name(nameToken.lexeme);
     // Cut off the "".
     name = name.substr(1, name.length() - 2);
     consume(SEMICOLON, "Expect ';' after import statement.");
 
-    if (mode == "Lib")
+    Module* module = nullptr;
+    if ((mode == "Lib") || (mode == "File"))
     {
-        fs::path libPath = "Libraries";
-        libPath /= name + ".lox";
-        std::ifstream libIn(libPath.string());
-        if (libIn.fail())
-            throw ParseError(nameToken, "No such library file.");
-        std::string libFile((std::istreambuf_iterator<char>(libIn)), 
-                                    std::istreambuf_iterator<char>());
-        Scanner tempScanner(libFile, name);
-        vT newTokens = tempScanner.scanTokens();
-        this->tokens.insert(this->tokens.begin() + current, 
-                                newTokens.begin(), newTokens.end() - 1);
+        module = import(mode, name);
+        if (module == nullptr)
+            throw ParseError(nameToken,
+                (mode == "Lib") ? "No such library file." : "No such Lox file.");
     }
 
-    else if (mode == "File")
+    return new Fetch(mode, name, module);
+}
+
+Module* Parser::import(const std::string& mode, const std::string& name)
+{
+    fs::path path = name;
+    if (mode == "Lib")
     {
-        std::ifstream fileIn(name);
-        if (fileIn.fail())
-            throw ParseError(nameToken, "No such Lox file.");
-        std::string loxFile((std::istreambuf_iterator<char>(fileIn)), 
-                                    std::istreambuf_iterator<char>());
-        Scanner tempScanner(loxFile, name);
-        vT newTokens = tempScanner.scanTokens();
-        this->tokens.insert(this->tokens.begin() + current, 
-                                newTokens.begin(), newTokens.end() - 1);
+        path = "Libraries";
+        path /= name + ".lox";
     }
 
-    return new Fetch(mode, name);
+    std::error_code error;
+    fs::path canonical = fs::canonical(path, error);
+    if (error) return nullptr;
+    fs::file_time_type modified = fs::last_write_time(canonical, error);
+
+    // Reuse the parse unless the file has changed since.
+    auto cached = modules.find(canonical.string());
+    if ((cached != modules.end()) && (cached->second.modified == modified))
+        return cached->second.module;
+
+    int file = SourceTable::load(path.string());
+    if (file == -1) return nullptr;
+
+    // Cached before parsing, so a file that imports itself (directly or
+    // not) gets this module back instead of recursing forever.
+    Module* module = new Module();
+    modules[canonical.string()] = {modified, module};
+    module->statements = AstCache::parse(file);
+
+    // Errors were reported; parse it again if it is fetched again.
+    if (Lox::failed()) modules.erase(canonical.string());
+    return module;
 }
 
 Stmt* Parser::forStatement()
@@ -236,6 +277,7 @@ Stmt* Parser::returnStatement()
     {
         std::cout << "Warning (line " << peek().line <<
                 "): code found after return statement (will be ignored).\n";
+        warnings++;
     }
 
     return new Return(keyword, value);
@@ -305,224 +347,251 @@ Stmt* Parser::function(std::string kind)
     }
 
     consume(LEFT_BRACE, "Expect '{' before " + kind + " body.");
-    vpS body = block();
-    return new Function(name, parameters, body);
-}
-
-vpS Parser::block()
-{
-    vpS statements;
+    // Unassigned lambdas are run where they stand, so only named
+    // functions and methods are worth a range for the AstCache.
+    if (kind == "")
+    {
+        vpS body = block();
+        return new Function(name, parameters, body);
+    }
 
-    while (!check(RIGHT_BRACE) && !isAtEnd())
-        statements.push_back(declaration());
+    std::string_view text = SourceTable::text(file);
+    LazyBody* lazy = new LazyBody();
+    lazy->file = file;
+    lazy->begin = previous().lexeme.data() + 1 - text.data();
+    lazy->line = previous().line;
+    lazy->column = previous().column;
+    lazy->loopType = loopType;
 
-    consume(RIGHT_BRACE, "Expect '}' after block.");
-    return statements;
-}
+    lazy->statements = block();
+    lazy->compiled = true;
+    lazy->end = previous().lexeme.data() + 1 - text.data();
 
-// Expression methods.
-Expr* Parser::expression()
-{
-    return comma();
+    Function* function = new Function(name, parameters, {});
+    function->lazy = lazy;
+    return function;
 }
 
-Expr* Parser::comma()
+void Parser::compile(LazyBody& lazy)
 {
-    vpE expressions;
-
-    Expr* expr = lambda();
-    expressions.push_back(expr);
-
-    while (match(COMMA))
+    Parser parser(lazy);
+    try
     {
-        expr = lambda();
-        expressions.push_back(expr);
+        lazy.statements = parser.block();
+    }
+    catch (ParseError& error)
+    {
+        error.show();
+        throw AbortError();
     }
 
-    if (expressions.size() > 1)
-        return new Comma(expressions);
-
-    return expr;
+    lazy.resolve(lazy.statements);
+    if (Lox::failed()) throw AbortError();
+    AstCache::commit();
+    if (lazy.optimize) lazy.optimize(lazy.statements);
+    lazy.compiled = true;
 }
 
-Expr* Parser::lambda()
+bool Parser::precompile(LazyBody& lazy)
 {
-    if (match(FUN))
+    Parser parser(lazy);
+    try
     {
-        consume(LEFT_PAREN, "Expect '(' after 'fun' keyword.");
-        vT parameters;
-        if (!check(RIGHT_PAREN))
-        {
-            do
-            {
-                if (parameters.size() >= 255)
-                    throw ParseError(peek(), "Can't have more than 255 parameters.");
-
-                parameters.push_back(consume(IDENTIFIER,  "Expect parameter name."));
-            } while (match(COMMA));
-        }
+        lazy.statements = parser.block();
+    }
+    catch (ParseError& error)
+    {
+        (void) error;
+        return false;
+    }
 
-        consume(RIGHT_PAREN, "Expect ')' after parameters.");
+    lazy.resolve(lazy.statements);
+    if (Lox::failed()) return false;
+    if (lazy.optimize) lazy.optimize(lazy.statements);
+    lazy.compiled = true;
+    return true;
+}
 
-        consume(LEFT_BRACE, "Expect '{' before lambda body.");
-        vpS body = block();
+vpS Parser::block()
+{
+    vpS statements;
 
-        return new Lambda(parameters, body);
-    }
+    while (!check(RIGHT_BRACE) && !isAtEnd())
+        statements.push_back(declaration());
 
-    return assignment();
+    consume(RIGHT_BRACE, "Expect '}' after block.");
+    return statements;
 }
 
-Expr* Parser::assignment()
+// Expression methods.
+
+// Expressions are parsed by precedence climbing over the table below.
+// Each token may start an expression (prefix) and/or continue one (infix),
+// and its levels keep the grammar as it was in recursive descent: a form
+// is only allowed where its level is at least the one being parsed, and
+// after an infix operator only operators of its level or lower may follow.
+const std::array<Parser::Rule, RIGHT_BRACKET + 1> Parser::rules = []
 {
-    Expr* expr = orExpr();
+    using P = Precedence;
+    std::array<Rule, RIGHT_BRACKET + 1> rules{};
 
-    if (match(EQUAL))
+    auto prefix = [&](TokenType type, Expr* (Parser::*parse)(), Precedence level)
     {
-        Token equals = previous();
-        Expr* value = assignment();
+        rules[type].prefix = parse;
+        rules[type].prefixPrecedence = level;
+    };
+    auto infix = [&](TokenType type, Expr* (Parser::*parse)(Expr*),
+                     Precedence level, Precedence operand)
+    {
+        rules[type].infix = parse;
+        rules[type].precedence = level;
+        rules[type].operand = operand;
+    };
+
+    for (TokenType type : {FALSE, TRUE, NIL, NUMBER, STRING, SUPER, THIS,
+                           IDENTIFIER, LEFT_BRACKET, LEFT_BRACE, LEFT_PAREN})
+        prefix(type, &Parser::primary, P::PRIMARY);
+    prefix(FUN, &Parser::lambda, P::LAMBDA);
+    prefix(BANG, &Parser::unary, P::UNARY);
+    prefix(MINUS, &Parser::unary, P::UNARY);
+
+    infix(COMMA, &Parser::comma, P::COMMA, P::LAMBDA);
+    infix(EQUAL, &Parser::assignment, P::ASSIGNMENT, P::ASSIGNMENT);
+    infix(OR, &Parser::logical, P::OR, P::AND);
+    // The right side of 'and' has always skipped the ternary level.
+    infix(AND, &Parser::logical, P::AND, P::EQUALITY);
+    infix(Q_MARK, &Parser::ternary, P::TERNARY, P::TERNARY);
+    for (TokenType type : {BANG_EQUAL, EQUAL_EQUAL})
+        infix(type, &Parser::binary, P::EQUALITY, P::COMPARISON);
+    for (TokenType type : {GREATER, GREATER_EQUAL, LESS, LESS_EQUAL})
+        infix(type, &Parser::binary, P::COMPARISON, P::TERM);
+    for (TokenType type : {MINUS, PLUS})
+        infix(type, &Parser::binary, P::TERM, P::FACTOR);
+    for (TokenType type : {SLASH, STAR, MOD})
+        infix(type, &Parser::binary, P::FACTOR, P::UNARY);
+    // Right-associative, and its right side takes no prefix operator.
+    infix(POWER, &Parser::binary, P::EXPONENT, P::EXPONENT);
+    infix(LEFT_PAREN, &Parser::finishCall, P::CALL, P::CALL);
+    infix(DOT, &Parser::property, P::CALL, P::CALL);
+    infix(LEFT_BRACKET, &Parser::finishSubscript, P::CALL, P::CALL);
+
+    return rules;
+}();
+
+Expr* Parser::expression(Precedence precedence)
+{
+    const Rule& start = rules[peek().type];
+    if ((start.prefix == nullptr) || (start.prefixPrecedence < precedence))
+        throw ParseError(peek(), "Expect expression.");
 
-        if (dynamic_cast<Variable*>(expr))
-        {
-            Token name = ((Variable *)expr)->name;
-            return new Assign(name, value);
-        }
+    advance();
+    Expr* expr = (this->*start.prefix)();
+    Precedence ceiling = start.prefixPrecedence;
 
-        else if (dynamic_cast<Get*>(expr))
-        {
-            Get* get = (Get*) expr;
-            return new Set(get->object, get->name, value);
-        }
+    while (true)
+    {
+        const Rule& rule = rules[peek().type];
+        if ((rule.infix == nullptr) || (rule.precedence < precedence) ||
+            (rule.precedence > ceiling))
+            break;
 
-        throw ParseError(equals, "Invalid assignment target.");
+        advance();
+        expr = (this->*rule.infix)(expr);
+        ceiling = rule.precedence;
     }
 
     return expr;
 }
 
-Expr* Parser::orExpr()
+Expr* Parser::lambda()
 {
-    Expr* expr = andExpr();
-
-    while (match(OR))
+    consume(LEFT_PAREN, "Expect '(' after 'fun' keyword.");
+    vT parameters;
+    if (!check(RIGHT_PAREN))
     {
-        Token lOperator = previous();
-        Expr* right = andExpr();
-        expr = new Logical(expr, lOperator, right);
-    }
+        do
+        {
+            if (parameters.size() >= 255)
+                throw ParseError(peek(), "Can't have more than 255 parameters.");
 
-    return expr;
-}
+            parameters.push_back(consume(IDENTIFIER,  "Expect parameter name."));
+        } while (match(COMMA));
+    }
 
-Expr* Parser::andExpr()
-{
-    Expr* expr = ternary();
+    consume(RIGHT_PAREN, "Expect ')' after parameters.");
 
-    while (match(AND))
-    {
-        Token lOperator = previous();
-        Expr* right = equality();
-        expr = new Logical(expr, lOperator, right);
-    }
+    consume(LEFT_BRACE, "Expect '{' before lambda body.");
+    vpS body = block();
 
-    return expr;
+    return new Lambda(parameters, body);
 }
 
-Expr* Parser::ternary()
+Expr* Parser::unary()
 {
-    Expr* expr = equality();
-
-    while (match(Q_MARK))
-    {
-        Expr* left = expression();
-        consume(COLON, "Expect colon separator between ternary operator branches.");
-        Expr* right = ternary();
-        expr = new Ternary(expr, left, right);
-    }
-
-    return expr;
+    Token uOperator = previous();
+    Expr* right = expression(Precedence::UNARY);
+    return new Unary(uOperator, right);
 }
 
-Expr* Parser::equality()
+Expr* Parser::comma(Expr* left)
 {
-    Expr* expr = comparison();
+    vpE expressions;
+    expressions.push_back(left);
 
-    while (match(BANG_EQUAL, EQUAL_EQUAL))
+    do
     {
-        Token bOperator = previous();
-        Expr* right = comparison();
-        expr = new Binary(expr, bOperator, right);
-    }
+        expressions.push_back(expression(Precedence::LAMBDA));
+    } while (match(COMMA));
 
-    return expr;
+    return new Comma(expressions);
 }
 
-Expr* Parser::comparison()
+Expr* Parser::assignment(Expr* target)
 {
-    Expr* expr = term();
+    Token equals = previous();
+    Expr* value = expression(Precedence::ASSIGNMENT);
 
-    while (match(GREATER, GREATER_EQUAL, LESS, LESS_EQUAL))
+    if (dynamic_cast<Variable*>(target))
     {
-        Token bOperator = previous();
-        Expr* right = term();
-        expr = new Binary(expr, bOperator, right);
+        Token name = ((Variable *)target)->name;
+        return new Assign(name, value);
     }
 
-    return expr;
-}
-
-Expr* Parser::term()
-{
-    Expr* expr = factor();
-
-    while (match(MINUS, PLUS))
+    else if (dynamic_cast<Get*>(target))
     {
-        Token bOperator = previous();
-        Expr* right = factor();
-        expr = new Binary(expr, bOperator, right);
+        Get* get = (Get*) target;
+        return new Set(get->object, get->name, value);
     }
 
-    return expr;
-}
-
-Expr* Parser::factor()
-{
-    Expr* expr = unary();
-
-    while (match(SLASH, STAR, MOD))
+    else if (dynamic_cast<Index*>(target))
     {
-        Token bOperator = previous();
-        Expr* right = unary();
-        expr = new Binary(expr, bOperator, right);
+        Index* index = (Index*) target;
+        return new SetIndex(index->object, index->bracket, index->index, value);
     }
 
-    return expr;
+    throw ParseError(equals, "Invalid assignment target.");
 }
 
-Expr* Parser::unary()
+Expr* Parser::logical(Expr* left)
 {
-    if (match(BANG, MINUS))
-    {
-        Token uOperator = previous();
-        Expr* right = unary();
-        return new Unary(uOperator, right);
-    }
-
-    return exponent();
+    Token lOperator = previous();
+    Expr* right = expression(rules[lOperator.type].operand);
+    return new Logical(left, lOperator, right);
 }
 
-Expr* Parser::exponent()
+Expr* Parser::ternary(Expr* condition)
 {
-    Expr* expr = call();
-
-    while (match(POWER))
-    {
-        Token bOperator = previous();
-        Expr* right = exponent();
-        expr = new Binary(expr, bOperator, right);
-    }
+    Expr* left = expression();
+    consume(COLON, "Expect colon separator between ternary operator branches.");
+    Expr* right = expression(Precedence::TERNARY);
+    return new Ternary(condition, left, right);
+}
 
-    return expr;
+Expr* Parser::binary(Expr* left)
+{
+    Token bOperator = previous();
+    Expr* right = expression(rules[bOperator.type].operand);
+    return new Binary(left, bOperator, right);
 }
 
 Expr* Parser::finishCall(Expr* callee)
@@ -537,8 +606,8 @@ Expr* Parser::finishCall(Expr* callee)
             if (arguments.size() > 255)
                 throw ParseError(peek(), "Can't have more than 255 arguments.");
             // Personal edit/change.
-            // lambda() instead of expression() to ignore comma expressions in function arguments.
-            arguments.push_back(lambda());
+            // Parsed above the comma level to ignore comma expressions in function arguments.
+            arguments.push_back(expression(Precedence::LAMBDA));
         } while (match(COMMA));
     }
 
@@ -547,24 +616,32 @@ Expr* Parser::finishCall(Expr* callee)
     return new Call(callee, paren, arguments);
 }
 
-Expr* Parser::call()
+Expr* Parser::finishSubscript(Expr* object)
 {
-    Expr* expr = primary();
+    Token bracket = previous();
 
-    while (true)
+    // Either bound of a slice may be left out: xs[:b], xs[a:], xs[:].
+    Expr* start = nullptr;
+    if (!check(COLON))
+        start = expression(Precedence::LAMBDA);
+
+    if (match(COLON))
     {
-        if (match(LEFT_PAREN))
-            expr = finishCall(expr);
-        else if (match(DOT))
-        {
-            Token name = consume(IDENTIFIER, "Expect property name after '.'.");
-            expr = new Get(expr, name);
-        }
-        else
-            break;
+        Expr* end = nullptr;
+        if (!check(RIGHT_BRACKET))
+            end = expression(Precedence::LAMBDA);
+        consume(RIGHT_BRACKET, "Expect ']' after slice.");
+        return new Slice(object, bracket, start, end);
     }
 
-    return expr;
+    consume(RIGHT_BRACKET, "Expect ']' after index.");
+    return new Index(object, bracket, start);
+}
+
+Expr* Parser::property(Expr* object)
+{
+    Token name = consume(IDENTIFIER, "Expect property name after '.'.");
+    return new Get(object, name);
 }
 
 Expr* Parser::list()
@@ -573,10 +650,10 @@ Expr* Parser::list()
     
     if (!check(RIGHT_BRACKET))
     {
-        elements.push_back(lambda());
+        elements.push_back(expression(Precedence::LAMBDA));
 
         while (match(COMMA))
-            elements.push_back(lambda());
+            elements.push_back(expression(Precedence::LAMBDA));
     }
     
     consume(RIGHT_BRACKET, "Expect ']' to close list.");
@@ -584,39 +661,66 @@ Expr* Parser::list()
     return new List(elements);
 }
 
-Expr* Parser::primary()
+Expr* Parser::dict()
 {
-    if (match(FALSE)) return new Literal(Object(false));
-    if (match(TRUE)) return new Literal(Object(true));
-    if (match(NIL)) return new Literal(Object(nullptr)); // Temporary.
+    Token brace = previous();
+    vpE keys;
+    vpE values;
 
-    if (match(NUMBER, STRING))
-        return new Literal(previous().literal);
-
-    if (match(SUPER))
+    if (!check(RIGHT_BRACE))
     {
-        Token keyword = previous();
-        consume(DOT, "Expect '.' after 'super'.");
-        Token method = consume(IDENTIFIER, "Expect superclass method name.");
-        return new Super(keyword, method);
+        do
+        {
+            keys.push_back(expression(Precedence::LAMBDA));
+            consume(COLON, "Expect ':' between dictionary key and value.");
+            values.push_back(expression(Precedence::LAMBDA));
+        } while (match(COMMA));
     }
 
-    if (match(THIS)) return new This(previous());
+    consume(RIGHT_BRACE, "Expect '}' to close dictionary.");
 
-    if (match(IDENTIFIER))
-        return new Variable(previous());
-    
-    if (match(LEFT_BRACKET))
-        return list();
+    return new Dict(brace, keys, values);
+}
 
-    if (match(LEFT_PAREN))
+Expr* Parser::primary()
+{
+    switch (previous().type)
     {
-        Expr* expr = expression();
-        consume(RIGHT_PAREN, "Expect ')' after expression.");
-        return new Grouping(expr);
-    }
+        case FALSE: return new Literal(Object(false));
+        case TRUE: return new Literal(Object(true));
+        case NIL: return new Literal(Object(nullptr)); // Temporary.
+
+        case NUMBER:
+        case STRING:
+            return new Literal(previous().literal());
+
+        case SUPER:
+        {
+            Token keyword = previous();
+            consume(DOT, "Expect '.' after 'super'.");
+            Token method = consume(IDENTIFIER, "Expect superclass method name.");
+            return new Super(keyword, method);
+        }
+
+        case THIS: return new This(previous());
 
-    throw ParseError(peek(), "Expect expression.");
+        case IDENTIFIER: return new Variable(previous());
+
+        case LEFT_BRACKET: return list();
+
+        // Statements take '{' as a block first, so this is only reached
+        // where an expression is expected.
+        case LEFT_BRACE: return dict();
+
+        case LEFT_PAREN:
+        {
+            Expr* expr = expression();
+            consume(RIGHT_PAREN, "Expect ')' after expression.");
+            return new Grouping(expr);
+        }
+
+        default: return nullptr; // Unreachable: only called for the tokens in the table.
+    }
 }
 
 // Helper methods.
@@ -635,11 +739,11 @@ bool Parser::match(Type... types)
 	return false;
 }
 
-Token Parser::consume(TokenType type, std::string message)
+const Token& Parser::consume(TokenType type, std::string_view message)
 {
     if (check(type)) return advance();
 
-    throw ParseError(peek(), message);
+    throw ParseError(peek(), std::string(message));
 }
 
 bool Parser::check(TokenType type)
@@ -648,9 +752,13 @@ bool Parser::check(TokenType type)
     return (peek().type == type);
 }
 
-Token Parser::advance()
+const Token& Parser::advance()
 {
-    if (!isAtEnd()) current++;
+    if (!isAtEnd())
+    {
+        previousToken = currentToken;
+        currentToken = scanner.next();
+    }
     return previous();
 }
 
@@ -659,36 +767,12 @@ bool Parser::isAtEnd()
     return (peek().type == eof);
 }
 
-Token Parser::peek()
-{
-    return tokens[current];
-}
-
-Token Parser::previous()
+const Token& Parser::peek()
 {
-    return tokens[current - 1];
+    return currentToken;
 }
 
-void Parser::synchronize()
+const Token& Parser::previous()
 {
-    advance();
-
-    while (!isAtEnd())
-    {
-        if (previous().type == SEMICOLON) return;
-
-        switch (peek().type) {
-            case CLASS:
-            case FUN:
-            case VAR:
-            case FOR:
-            case IF:
-            case WHILE:
-            case PRINT:
-            case RETURN:
-                return;
-        }
-
-        advance();
-    }
+    return previousToken;
 }
\ No newline at end of file
@@ -0,0 +1,441 @@
+#include "../include/Pruner.h"
+#include "../include/Expr.h"
+#include "../include/Nodes.h"
+#include "../include/Object.h"
+#include "../include/Scanner.h"
+#include "../include/Stmt.h"
+#include "../include/Token.h"
+#include "../include/TokenType.h"
+#include <set>
+#include <string_view>
+#include <vector>
+
+// General methods.
+
+void Pruner::prune(vpS& statements)
+{
+    topLevel(statements);
+
+    bool changed = true;
+    while (changed)
+    {
+        while (!pending.empty())
+        {
+            Candidate* candidate = pending.back();
+            pending.pop_back();
+            walkDeclaration(candidate->stmt);
+        }
+
+        // Walking may have made some subclass unsafe to drop.
+        changed = false;
+        for (Candidate& candidate : declarations)
+        {
+            if (!candidate.kept && !droppable(&candidate))
+            {
+                keep(&candidate);
+                changed = true;
+            }
+        }
+    }
+
+    std::set<Stmt*> dropped;
+    for (Candidate& candidate : declarations)
+    {
+        if (!candidate.kept)
+            dropped.insert(candidate.stmt);
+    }
+    if (dropped.empty()) return;
+
+    for (vpS* list : lists)
+        std::erase_if(*list, [&dropped](Stmt* stmt) { return dropped.contains(stmt); });
+    for (Stmt* stmt : dropped)
+        discard(stmt);
+}
+
+// Registers the declarations in a top-level list and walks the rest.
+void Pruner::topLevel(vpS& statements)
+{
+    lists.push_back(&statements);
+    std::set<std::string_view> classes;
+
+    for (Stmt* stmt : statements)
+    {
+        Candidate candidate = {stmt, {}, {}, false};
+        if (auto function = dynamic_cast<Function*>(stmt))
+        {
+            if (function->name.lexeme.empty())
+            {
+                walk(stmt);
+                continue;
+            }
+            candidate.name = function->name.lexeme;
+        }
+        else if (auto klass = dynamic_cast<Class*>(stmt))
+        {
+            candidate.name = klass->name.lexeme;
+            if (klass->superclass != nullptr)
+            {
+                auto super = dynamic_cast<Variable*>(klass->superclass);
+                candidate.superclass = (super != nullptr) ? super->name.lexeme : "super";
+                candidate.afterSuperclass = (super != nullptr) && classes.contains(super->name.lexeme);
+            }
+            classes.insert(candidate.name);
+        }
+        else
+        {
+            walk(stmt);
+            continue;
+        }
+
+        declarations.push_back(candidate);
+        Candidate* added = &declarations.back();
+        candidates[added->name].push_back(added);
+        if (used.contains(added->name))
+            keep(added);
+    }
+}
+
+bool Pruner::rebinds(std::string_view name) const
+{
+    return rebound.contains(name);
+}
+
+bool Pruner::importsLater() const
+{
+    return importsUnparsed;
+}
+
+void Pruner::use(std::string_view name)
+{
+    if (!used.insert(name).second) return;
+
+    auto found = candidates.find(name);
+    if (found == candidates.end()) return;
+    for (Candidate* candidate : found->second)
+        keep(candidate);
+}
+
+void Pruner::keep(Candidate* candidate)
+{
+    if (candidate->kept) return;
+    candidate->kept = true;
+    pending.push_back(candidate);
+}
+
+// Declaring a subclass checks its superclass at runtime, and that check
+// must still fail where it did. So one is dropped only when the
+// superclass is surely a class by then.
+bool Pruner::droppable(Candidate* candidate)
+{
+    if (candidate->superclass.empty()) return true;
+    if (!candidate->afterSuperclass || rebound.contains(candidate->superclass))
+        return false;
+
+    for (Candidate* other : candidates[candidate->superclass])
+    {
+        if (dynamic_cast<Class*>(other->stmt) == nullptr)
+            return false;
+    }
+    return true;
+}
+
+void Pruner::walk(const vpS& statements)
+{
+    for (Stmt* stmt : statements)
+        walk(stmt);
+}
+
+void Pruner::walk(Stmt* stmt)
+{
+    stmt->accept(*this);
+}
+
+void Pruner::walk(Expr* expr)
+{
+    (void) expr->accept(*this); // Unused return value.
+}
+
+void Pruner::walkDeclaration(Stmt* stmt)
+{
+    if (auto function = dynamic_cast<Function*>(stmt))
+        walkBody(function);
+    else
+        walk(stmt);
+}
+
+void Pruner::walkBody(Function* function)
+{
+    if (function->lazy == nullptr)
+        walk(function->body);
+    else if (function->lazy->compiled)
+        walk(function->lazy->statements);
+    else
+        scanBody(*function->lazy);
+}
+
+// An unparsed body is only looked at as tokens: every identifier in it
+// counts as used, and as rebound where it is declared or assigned. What
+// it imports can't be known yet.
+void Pruner::scanBody(const LazyBody& lazy)
+{
+    Scanner scanner(lazy.file, lazy.begin, lazy.end, lazy.line, lazy.column);
+    TokenType before = LEFT_BRACE;
+    std::string_view name;
+
+    for (Token token = scanner.next(); token.type != eof; token = scanner.next())
+    {
+        if (token.type == IDENTIFIER)
+        {
+            use(token.lexeme);
+            if ((before == VAR) || (before == FIX) || (before == FUN) || (before == CLASS))
+                rebound.insert(token.lexeme);
+            name = token.lexeme;
+        }
+        else if ((token.type == EQUAL) && (before == IDENTIFIER))
+            rebound.insert(name);
+        else if (token.type == GET)
+            importsUnparsed = true;
+        before = token.type;
+    }
+}
+
+// Frees a dropped declaration, as far as nothing else can still point
+// into it. Expressions are left alone: the Interpreter keys resolved
+// variables by their address.
+void Pruner::discard(Stmt* stmt)
+{
+    if (auto function = dynamic_cast<Function*>(stmt))
+    {
+        if ((function->lazy == nullptr) || function->lazy->compiled) return;
+        delete function->lazy;
+        delete function->params;
+        delete function;
+    }
+    else if (auto klass = dynamic_cast<Class*>(stmt))
+    {
+        for (Stmt* method : klass->methods)
+            discard(method);
+        for (Stmt* method : klass->classMethods)
+            discard(method);
+        delete klass;
+    }
+}
+
+// Statement methods.
+
+void Pruner::visitBreakStmt(Break* stmt)
+{
+    (void) stmt;
+}
+
+void Pruner::visitBlockStmt(Block* stmt)
+{
+    walk(stmt->statements);
+}
+
+void Pruner::visitClassStmt(Class* stmt)
+{
+    rebound.insert(stmt->name.lexeme);
+    if (stmt->superclass != nullptr)
+        walk(stmt->superclass);
+    for (Stmt* method : stmt->methods)
+        walkBody(dynamic_cast<Function*>(method));
+    for (Stmt* method : stmt->classMethods)
+        walkBody(dynamic_cast<Function*>(method));
+}
+
+void Pruner::visitContinueStmt(Continue* stmt)
+{
+    (void) stmt;
+}
+
+void Pruner::visitExpressionStmt(Expression* stmt)
+{
+    walk(stmt->expression);
+}
+
+void Pruner::visitFetchStmt(Fetch* stmt)
+{
+    if ((stmt->module != nullptr) && modules.insert(stmt->module).second)
+        topLevel(stmt->module->statements);
+}
+
+void Pruner::visitFunctionStmt(Function* stmt)
+{
+    rebound.insert(stmt->name.lexeme);
+    walkBody(stmt);
+}
+
+void Pruner::visitIfStmt(If* stmt)
+{
+    walk(stmt->condition);
+    walk(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr)
+        walk(stmt->elseBranch);
+}
+
+void Pruner::visitPrintStmt(Print* stmt)
+{
+    walk(stmt->expression);
+}
+
+void Pruner::visitReturnStmt(Return* stmt)
+{
+    if (stmt->value != nullptr)
+        walk(stmt->value);
+}
+
+void Pruner::visitVarStmt(Var* stmt)
+{
+    rebound.insert(stmt->name.lexeme);
+    if (stmt->initializer != nullptr)
+        walk(stmt->initializer);
+}
+
+void Pruner::visitWhileStmt(While* stmt)
+{
+    walk(stmt->condition);
+    walk(stmt->body);
+}
+
+// Expression methods.
+
+Object Pruner::visitAssignExpr(Assign* expr)
+{
+    use(expr->name.lexeme);
+    rebound.insert(expr->name.lexeme);
+    walk(expr->value);
+    return Object(nullptr);
+}
+
+Object Pruner::visitBinaryExpr(Binary* expr)
+{
+    walk(expr->left);
+    walk(expr->right);
+    return Object(nullptr);
+}
+
+Object Pruner::visitCallExpr(Call* expr)
+{
+    walk(expr->callee);
+    for (Expr* argument : expr->arguments)
+        walk(argument);
+    return Object(nullptr);
+}
+
+Object Pruner::visitCommaExpr(Comma* expr)
+{
+    for (Expr* expression : expr->expressions)
+        walk(expression);
+    return Object(nullptr);
+}
+
+Object Pruner::visitDictExpr(Dict* expr)
+{
+    for (int i = 0; i < (int) expr->keys.size(); i++)
+    {
+        walk(expr->keys[i]);
+        walk(expr->values[i]);
+    }
+    return Object(nullptr);
+}
+
+Object Pruner::visitGetExpr(Get* expr)
+{
+    walk(expr->object);
+    return Object(nullptr);
+}
+
+Object Pruner::visitGroupingExpr(Grouping* expr)
+{
+    walk(expr->expression);
+    return Object(nullptr);
+}
+
+Object Pruner::visitIndexExpr(Index* expr)
+{
+    walk(expr->object);
+    walk(expr->index);
+    return Object(nullptr);
+}
+
+Object Pruner::visitLambdaExpr(Lambda* expr)
+{
+    walk(expr->body);
+    return Object(nullptr);
+}
+
+Object Pruner::visitListExpr(List* expr)
+{
+    for (Expr* element : expr->elements)
+        walk(element);
+    return Object(nullptr);
+}
+
+Object Pruner::visitLiteralExpr(Literal* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Pruner::visitLogicalExpr(Logical* expr)
+{
+    walk(expr->left);
+    walk(expr->right);
+    return Object(nullptr);
+}
+
+Object Pruner::visitSetExpr(Set* expr)
+{
+    walk(expr->value);
+    walk(expr->object);
+    return Object(nullptr);
+}
+
+Object Pruner::visitSetIndexExpr(SetIndex* expr)
+{
+    walk(expr->value);
+    walk(expr->object);
+    walk(expr->index);
+    return Object(nullptr);
+}
+
+Object Pruner::visitSliceExpr(Slice* expr)
+{
+    walk(expr->object);
+    if (expr->start != nullptr) walk(expr->start);
+    if (expr->end != nullptr) walk(expr->end);
+    return Object(nullptr);
+}
+
+Object Pruner::visitSuperExpr(Super* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Pruner::visitTernaryExpr(Ternary* expr)
+{
+    walk(expr->condition);
+    walk(expr->trueBranch);
+    walk(expr->falseBranch);
+    return Object(nullptr);
+}
+
+Object Pruner::visitThisExpr(This* expr)
+{
+    (void) expr;
+    return Object(nullptr);
+}
+
+Object Pruner::visitUnaryExpr(Unary* expr)
+{
+    walk(expr->right);
+    return Object(nullptr);
+}
+
+Object Pruner::visitVariableExpr(Variable* expr)
+{
+    use(expr->name.lexeme);
+    return Object(nullptr);
+}
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "../include/Stmt.h"
 #include "../include/Token.h"
 #include <string>
+#include <utility>
+#include <vector>
 
 #define FALSE -1
 #define TRUE 1
@@ -34,16 +36,16 @@ void Resolver::declare(Token name)
 {
     if (scopes.size() == 0) return;
 
-    std::map<std::string, int> scope = scopes[scopes.size() - 1];
+    std::map<std::string, int, std::less<>>& scope = scopes[scopes.size() - 1];
     if (scope.contains(name.lexeme))
         throw StaticError(name, "Already a variable with this name in this scope.");
-    scopes[scopes.size() - 1][name.lexeme] = FALSE;
+    scope[std::string(name.lexeme)] = FALSE;
 }
 
 void Resolver::define(Token name)
 {
     if (scopes.size() == 0) return;
-    scopes[scopes.size() - 1][name.lexeme] = TRUE;
+    scopes[scopes.size() - 1][std::string(name.lexeme)] = TRUE;
 }
 
 void Resolver::resolve(vpS statements)
@@ -85,6 +87,9 @@ void Resolver::resolveFunction(Function* function, FunctionType type)
 {
     FunctionType enclosingFunction = currentFunction;
     currentFunction = type;
+    std::vector<bool*> enclosingCapturing = std::move(capturing);
+    capturing = {(function->lazy != nullptr) ? &function->lazy->makesClosures
+                                             : &function->makesClosures};
     beginScope();
     if (function->params != nullptr)
     {
@@ -94,8 +99,27 @@ void Resolver::resolveFunction(Function* function, FunctionType type)
             define(param);
         }
     }
-    resolve(function->body);
+    if (function->lazy == nullptr)
+        resolve(function->body);
+    else if (function->lazy->compiled)
+        resolve(function->lazy->statements);
+    else
+    {
+        // Resolved on first call, as if it were still here.
+        function->lazy->resolve = [interpreter = interpreter, scopes = scopes,
+                                   type, currentClass = currentClass,
+                                   lazy = function->lazy](vpS& body)
+        {
+            Resolver resolver(*interpreter);
+            resolver.scopes = scopes;
+            resolver.currentFunction = type;
+            resolver.currentClass = currentClass;
+            resolver.capturing = {&lazy->makesClosures};
+            resolver.resolve(body);
+        };
+    }
     endScope();
+    capturing = std::move(enclosingCapturing);
     currentFunction = enclosingFunction;
 }
 
@@ -103,6 +127,8 @@ void Resolver::resolveLambda(Lambda* lambda, FunctionType type)
 {
     FunctionType enclosingLambda = currentFunction;
     currentFunction = type;
+    std::vector<bool*> enclosingCapturing = std::move(capturing);
+    capturing = {&lambda->makesClosures};
 
     beginScope();
     for (Token param : lambda->params)
@@ -112,9 +138,18 @@ void Resolver::resolveLambda(Lambda* lambda, FunctionType type)
     }
     resolve(lambda->body);
     endScope();
+    capturing = std::move(enclosingCapturing);
     currentFunction = enclosingLambda;
 }
 
+// A function, lambda or class made here closes over the environments of
+// the enclosing blocks and call, so they have to outlive the call.
+void Resolver::makeClosure()
+{
+    for (bool* makesClosures : capturing)
+        *makesClosures = true;
+}
+
 // Statement methods.
 
 void Resolver::visitBreakStmt(Break* stmt)
@@ -125,7 +160,9 @@ void Resolver::visitBreakStmt(Break* stmt)
 void Resolver::visitBlockStmt(Block* stmt)
 {
     beginScope();
+    capturing.push_back(&stmt->makesClosures);
     resolve(stmt->statements);
+    capturing.pop_back();
     endScope();
 }
 
@@ -133,6 +170,7 @@ void Resolver::visitClassStmt(Class* stmt)
 {
     ClassType enclosingClass = currentClass;
     currentClass = CLASS;
+    makeClosure();
 
     declare(stmt->name);
     define(stmt->name);
@@ -186,13 +224,34 @@ void Resolver::visitExpressionStmt(Expression* stmt)
 
 void Resolver::visitFetchStmt(Fetch* stmt)
 {
-    (void) stmt;
+    if (stmt->module == nullptr) return;
+
+    // Resolved once, apart from any importing scope, as it runs in an
+    // environment of its own.
+    Module* module = stmt->module;
+    if (!module->resolved)
+    {
+        module->resolved = true;
+        Resolver resolver(*interpreter);
+        resolver.beginScope();
+        resolver.resolve(module->statements);
+        for (auto& [name, state] : resolver.scopes.back())
+        {
+            if (state == TRUE) module->names.push_back(name);
+        }
+    }
+
+    for (std::string& name : module->names)
+    {
+        if (scopes.size() != 0) scopes[scopes.size() - 1][name] = TRUE;
+    }
 }
 
 void Resolver::visitFunctionStmt(Function* stmt)
 {
     declare(stmt->name);
     define(stmt->name);
+    if (stmt->name.line != 0) makeClosure();
 
     resolveFunction(stmt, FUNCTION);
 }
@@ -271,6 +330,16 @@ Object Resolver::visitCommaExpr(Comma* expr)
     return Object(nullptr);
 }
 
+Object Resolver::visitDictExpr(Dict* expr)
+{
+    for (int i = 0; i < (int) expr->keys.size(); i++)
+    {
+        resolve(expr->keys[i]);
+        resolve(expr->values[i]);
+    }
+    return Object(nullptr);
+}
+
 Object Resolver::visitGetExpr(Get* expr)
 {
     resolve(expr->object);
@@ -283,8 +352,16 @@ Object Resolver::visitGroupingExpr(Grouping* expr)
     return Object(nullptr);
 }
 
+Object Resolver::visitIndexExpr(Index* expr)
+{
+    resolve(expr->object);
+    resolve(expr->index);
+    return Object(nullptr);
+}
+
 Object Resolver::visitLambdaExpr(Lambda* expr)
 {
+    makeClosure();
     resolveLambda(expr, LAMBDA);
     return Object(nullptr);
 }
@@ -316,6 +393,22 @@ Object Resolver::visitSetExpr(Set* expr)
     return Object(nullptr);
 }
 
+Object Resolver::visitSetIndexExpr(SetIndex* expr)
+{
+    resolve(expr->value);
+    resolve(expr->object);
+    resolve(expr->index);
+    return Object(nullptr);
+}
+
+Object Resolver::visitSliceExpr(Slice* expr)
+{
+    resolve(expr->object);
+    if (expr->start != nullptr) resolve(expr->start);
+    if (expr->end != nullptr) resolve(expr->end);
+    return Object(nullptr);
+}
+
 Object Resolver::visitSuperExpr(Super* expr)
 {
     if (currentClass == NOCLASS)
@@ -351,7 +444,7 @@ Object Resolver::visitUnaryExpr(Unary* expr)
 
 Object Resolver::visitVariableExpr(Variable* expr)
 {
-    std::string name = expr->name.lexeme;
+    std::string name(expr->name.lexeme);
     
     if (!(scopes.size() == 0) && (scopes[scopes.size() - 1][name] == FALSE))
         throw StaticError(expr->name, "Can't read local variable in its own initializer.");
@@ -2,39 +2,358 @@
 #include "../include/Error.h"
 #include "../include/Lox.h"
 #include "../include/Object.h"
+#include "../include/SourceTable.h"
 #include "../include/TokenType.h"
+#include <algorithm>
+#include <bit>
 #include <cctype>
+#include <cstdint>
+#include <deque>
+#include <future>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-Scanner::Scanner(std::string& source, std::string& fileName)
-{
-	this->source = source;
-    this->fileName = fileName;
-	keywords["and"] = AND;
-    keywords["break"] = BREAK;
-	keywords["class"] = CLASS;
-    keywords["continue"] = CONTINUE;
-	keywords["else"] = ELSE;
-	keywords["false"] = FALSE;
-	keywords["fix"] = FIX;
-	keywords["for"] = FOR;
-	keywords["fun"] = FUN;
-	keywords["if"] = IF;
-	keywords["nil"] = NIL;
-	keywords["or"] = OR;
-	keywords["print"] = PRINT;
-	keywords["return"] = RETURN;
-	keywords["super"] = SUPER;
-	keywords["this"] = THIS;
-	keywords["true"] = TRUE;
-	keywords["var"] = VAR;
-	keywords["while"] = WHILE;
-    keywords["GetMod"] = GET;
-    keywords["GetLib"] = GET;
-    keywords["GetFile"] = GET;
+// Keywords are told apart by their first character and length, so an
+// identifier needs at most one comparison (and no allocation) to classify.
+static constexpr TokenType keywordType(std::string_view text)
+{
+    auto is = [&](std::string_view keyword, TokenType type) {
+        return (text == keyword) ? type : IDENTIFIER;
+    };
+
+    switch (text[0])
+    {
+        case 'a': return is("and", AND);
+        case 'b': return is("break", BREAK);
+        case 'c':
+            if (text.size() == 5) return is("class", CLASS);
+            return is("continue", CONTINUE);
+        case 'e': return is("else", ELSE);
+        case 'f':
+            if (text.size() == 5) return is("false", FALSE);
+            if ((text.size() == 3) && (text[1] == 'i')) return is("fix", FIX);
+            if ((text.size() == 3) && (text[1] == 'o')) return is("for", FOR);
+            return is("fun", FUN);
+        case 'i': return is("if", IF);
+        case 'n': return is("nil", NIL);
+        case 'o': return is("or", OR);
+        case 'p': return is("print", PRINT);
+        case 'r': return is("return", RETURN);
+        case 's': return is("super", SUPER);
+        case 't':
+            if (text.size() == 4) return ((text[1] == 'h') ? is("this", THIS) : is("true", TRUE));
+            return IDENTIFIER;
+        case 'v': return is("var", VAR);
+        case 'w': return is("while", WHILE);
+        case 'G':
+            if (text.size() == 7) return is("GetFile", GET);
+            if ((text.size() == 6) && (text[3] == 'M')) return is("GetMod", GET);
+            return is("GetLib", GET);
+    }
+    return IDENTIFIER;
+}
+
+static_assert(keywordType("continue") == CONTINUE);
+static_assert(keywordType("fun") == FUN);
+static_assert(keywordType("GetLib") == GET);
+static_assert(keywordType("format") == IDENTIFIER);
+
+// Fast paths for the long runs in a source file (blanks, comments, string
+// bodies, identifiers). Each checks 16 characters at a time while a whole
+// block fits before the end of the source, then finishes one by one.
+// They only find where a run ends; the caller does the line/column upkeep.
+
+#ifdef __SSE2__
+static __m128i load(std::string_view text, size_t i)
+{
+    return _mm_loadu_si128((const __m128i *) (text.data() + i));
+}
+
+static __m128i equal(__m128i bytes, char c)
+{
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c));
+}
+
+// Signed compares, so bytes of 128 and up (UTF-8) are never in range.
+static __m128i inRange(__m128i bytes, char low, char high)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(low - 1)),
+                         _mm_cmplt_epi8(bytes, _mm_set1_epi8(high + 1)));
+}
+
+// Offset of the first set lane, or 16 when there is none.
+static size_t firstSet(__m128i mask)
+{
+    uint32_t bits = (uint32_t) _mm_movemask_epi8(mask);
+    return (bits == 0) ? 16 : std::countr_zero(bits);
+}
+#endif
+
+static bool isBlank(char c)
+{
+    return ((c == ' ') || (c == '\t') || (c == '\r'));
+}
+
+static bool isIdentifierChar(char c)
+{
+    return (isalnum((unsigned char) c) || (c == '_'));
+}
+
+// First position at or after i that is not a space, tab or carriage return.
+static size_t skipBlanks(std::string_view text, size_t i)
+{
+#ifdef __SSE2__
+    for (; i + 16 <= text.size(); i += 16)
+    {
+        __m128i bytes = load(text, i);
+        __m128i blank = _mm_or_si128(_mm_or_si128(equal(bytes, ' '), equal(bytes, '\t')),
+                                     equal(bytes, '\r'));
+        size_t offset = firstSet(_mm_xor_si128(blank, _mm_set1_epi8(-1)));
+        if (offset != 16) return i + offset;
+    }
+#endif
+    while ((i < text.size()) && isBlank(text[i])) i++;
+    return i;
+}
+
+// First position at or after i that cannot continue an identifier.
+static size_t skipIdentifier(std::string_view text, size_t i)
+{
+#ifdef __SSE2__
+    for (; i + 16 <= text.size(); i += 16)
+    {
+        __m128i bytes = load(text, i);
+        __m128i word = _mm_or_si128(_mm_or_si128(inRange(bytes, 'a', 'z'), inRange(bytes, 'A', 'Z')),
+                                    _mm_or_si128(inRange(bytes, '0', '9'), equal(bytes, '_')));
+        size_t offset = firstSet(_mm_xor_si128(word, _mm_set1_epi8(-1)));
+        if (offset != 16) return i + offset;
+    }
+#endif
+    while ((i < text.size()) && isIdentifierChar(text[i])) i++;
+    return i;
+}
+
+// First position at or after i holding one of a, b or c (or the end).
+static size_t findAny(std::string_view text, size_t i, char a, char b, char c)
+{
+#ifdef __SSE2__
+    for (; i + 16 <= text.size(); i += 16)
+    {
+        __m128i bytes = load(text, i);
+        size_t offset = firstSet(_mm_or_si128(_mm_or_si128(equal(bytes, a), equal(bytes, b)),
+                                              equal(bytes, c)));
+        if (offset != 16) return i + offset;
+    }
+#endif
+    while ((i < text.size()) && (text[i] != a) && (text[i] != b) && (text[i] != c)) i++;
+    return i;
+}
+
+// Parallel scanning splits the source at newlines that are outside any
+// string or block comment. Finding them takes a quick pass that follows
+// only what the scanner would treat as quotes and comment markers,
+// counting lines on the way so every piece knows where it starts.
+
+static const size_t PARALLEL_MINIMUM = 4 << 20;
+static const size_t PARALLEL_PART = 1 << 20;
+// Pieces scanned at once, and so held ahead of the parser, at most.
+static const size_t PARALLEL_AHEAD = 8;
+
+std::vector<Scanner::Cut> Scanner::findCuts(std::string_view text, unsigned int parts)
+{
+    std::vector<Cut> cuts;
+    size_t target = text.size() / parts;
+    unsigned int line = 1;
+    int depth = 0; // Block comment nesting.
+    bool inString = false;
+
+    size_t i = 0;
+    while (i < text.size())
+    {
+        if (inString)
+        {
+            i = findAny(text, i, '"', '\n', '"');
+            if (i == text.size()) break;
+            if (text[i] == '\n') line++;
+            else inString = false;
+            i++;
+        }
+        else if (depth > 0)
+        {
+            i = findAny(text, i, '/', '*', '\n');
+            if (i == text.size()) break;
+            if (text[i] == '\n') line++;
+            else if ((text[i] == '/') && (i + 1 < text.size()) && (text[i + 1] == '*'))
+            {
+                depth++;
+                i++;
+            }
+            else if ((text[i] == '*') && (i + 1 < text.size()) && (text[i + 1] == '/'))
+            {
+                depth--;
+                i++;
+            }
+            i++;
+        }
+        else
+        {
+            i = findAny(text, i, '"', '/', '\n');
+            if (i == text.size()) break;
+            if (text[i] == '"')
+                inString = true;
+            else if (text[i] == '/')
+            {
+                if ((i + 1 < text.size()) && (text[i + 1] == '/'))
+                    // Line comment: carry on from its newline.
+                    i = findAny(text, i + 2, '\n', '\n', '\n') - 1;
+                else if ((i + 1 < text.size()) && (text[i + 1] == '*'))
+                {
+                    depth = 1;
+                    i++;
+                }
+            }
+            else
+            {
+                line++;
+                if (i + 1 >= target)
+                {
+                    cuts.push_back({i + 1, line});
+                    if (cuts.size() == parts - 1) break;
+                    target = text.size() / parts * (cuts.size() + 1);
+                }
+            }
+            i++;
+        }
+    }
+
+    return cuts;
+}
+
+Scanner::Scanner(int file)
+{
+	this->source = SourceTable::text(file);
+    this->file = file;
+    this->fileName = SourceTable::name(file);
+}
+
+Scanner::Scanner(int file, size_t begin, size_t end, unsigned int line,
+                 unsigned int column)
+{
+	this->source = SourceTable::text(file).substr(0, end);
+    this->file = file;
+    this->fileName = SourceTable::name(file);
+    this->current = begin;
+    this->line = line;
+    this->column = column;
+    this->started = true; // A part is never split up further.
 }
 
 std::vector<Token> Scanner::scanTokens()
+{
+	unsigned int parts = parallelParts();
+	if (parts > 1)
+		scanParallel(parts);
+	else
+		scanRange();
+
+	for (ScanError& error : errors)
+		error.show();
+
+	tokens.push_back(Token(eof, "", line, column, file));
+	return tokens;
+}
+
+Token Scanner::next()
+{
+	if (!started)
+	{
+		started = true;
+		// A big source is scanned in pieces on other threads, only a few
+		// pieces ahead of the parser, so memory doesn't grow with it.
+		if (parallelParts() > 1)
+		{
+			cuts = findCuts(source, (unsigned int) (source.size() / PARALLEL_PART));
+			cuts.push_back({source.size(), 0});
+			current = (unsigned int) source.size(); // Left to the pieces.
+			while ((ahead.size() < parallelParts()) && scanAhead()) {}
+		}
+	}
+
+	while ((served == tokens.size()) && !ahead.empty())
+	{
+		Scanner piece = ahead.front().get();
+		ahead.pop_front();
+		for (ScanError& error : piece.errors)
+			error.show();
+		// The used up buffer goes to the next piece, so the same few
+		// buffers go round instead of each thread allocating its own.
+		tokens.swap(piece.tokens);
+		piece.tokens.clear();
+		scanAhead(std::move(piece.tokens));
+		served = 0;
+		line = piece.line;
+		column = piece.column;
+	}
+
+	if (served < tokens.size())
+		return tokens[served++];
+
+	// Otherwise scan on demand, keeping at most one token around.
+	tokens.clear();
+	served = 0;
+	while (tokens.empty() && !isAtEnd())
+	{
+		start = current;
+		try
+		{
+			scanToken();
+		}
+		catch (ScanError& error)
+		{
+			error.show();
+		}
+	}
+
+	if (tokens.empty())
+		return Token(eof, "", line, column, file);
+	served = 1;
+	return tokens[0];
+}
+
+unsigned int Scanner::parallelParts()
+{
+	// Only worth the threads for big inputs, split in big pieces.
+	if (source.size() < PARALLEL_MINIMUM) return 1;
+	return std::min<size_t>({std::thread::hardware_concurrency(),
+	                         source.size() / PARALLEL_PART, PARALLEL_AHEAD});
+}
+
+// Starts scanning the next piece for next(), if one is left, into the
+// given buffer.
+bool Scanner::scanAhead(std::vector<Token> buffer)
+{
+	if (nextCut == cuts.size()) return false;
+
+	size_t begin = (nextCut == 0) ? 0 : cuts[nextCut - 1].offset;
+	unsigned int firstLine = (nextCut == 0) ? 1 : cuts[nextCut - 1].line;
+	// Made here: the SourceTable may grow on this thread meanwhile.
+	Scanner piece(file, begin, cuts[nextCut].offset, firstLine);
+	piece.tokens = std::move(buffer);
+	nextCut++;
+	ahead.push_back(std::async(std::launch::async, [piece = std::move(piece)]() mutable
+	{
+		piece.scanRange();
+		return std::move(piece);
+	}));
+	return true;
+}
+
+void Scanner::scanRange()
 {
 	while (!isAtEnd())
 	{
@@ -45,12 +364,47 @@ std::vector<Token> Scanner::scanTokens()
         }
         catch (ScanError& error)
         {
-            error.show();
+            errors.push_back(error);
         }
 	}
+}
 
-	tokens.push_back(Token(eof, "", Object(nullptr), line, column, fileName));
-	return tokens;
+void Scanner::scanParallel(unsigned int parts)
+{
+    std::vector<Cut> ends = findCuts(source, parts);
+    ends.push_back({source.size(), 0});
+
+    // A deque, as a Scanner can only be moved, not copied.
+    std::deque<Scanner> pieces;
+    size_t begin = 0;
+    unsigned int firstLine = 1;
+    for (Cut& cut : ends)
+    {
+        pieces.push_back(Scanner(file, begin, cut.offset, firstLine));
+        begin = cut.offset;
+        firstLine = cut.line;
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < pieces.size(); i++)
+        threads.emplace_back(&Scanner::scanRange, &pieces[i]);
+    pieces[0].scanRange();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    size_t count = 0;
+    for (Scanner& piece : pieces)
+        count += piece.tokens.size();
+    tokens.reserve(count + 1);
+    for (Scanner& piece : pieces)
+    {
+        tokens.insert(tokens.end(), piece.tokens.begin(), piece.tokens.end());
+        errors.insert(errors.end(), piece.errors.begin(), piece.errors.end());
+    }
+
+    current = (unsigned int) source.size();
+    line = pieces.back().line;
+    column = pieces.back().column;
 }
 
 bool Scanner::match(char expected)
@@ -58,6 +412,7 @@ bool Scanner::match(char expected)
 	if (isAtEnd()) return false;
 	if (source[current] != expected) return false;
 	current++;
+    column++;
 	return true;
 }
 
@@ -86,19 +441,14 @@ char Scanner::advance()
 
 void Scanner::addToken(TokenType type)
 {
-	addToken(type, Object(nullptr));
-}
-
-void Scanner::addToken(TokenType type, Object literal)
-{
-	std::string text = source.substr(start, current - start);
-	tokens.push_back(Token(type, text, literal, line, column, fileName));
+	tokens.push_back(Token(type, source.substr(start, current - start), line, startColumn, file));
 }
 
 void Scanner::scanToken()
 {
 	char c = advance();
     column++;
+    startColumn = column;
 
 	switch (c)
 	{
@@ -135,8 +485,8 @@ void Scanner::scanToken()
 		case '/':
 			if (match('/'))
 			{
-				// A comment goes until the end of the line.
-				while ((peek() != '\n') && !isAtEnd()) advance();
+				// A comment goes until the end of the line (which resets the column).
+				current = findAny(source, current, '\n', '\n', '\n');
 			}
 
 			else if (match('*'))
@@ -144,20 +494,34 @@ void Scanner::scanToken()
 				int count = 1;
 				while ((count != 0) && !isAtEnd())
 				{
-					// Newlines: increment line and skip a character.
-					if (peek() == '\n') line++;
-					else if ((peek() == '/') && (peekNext() == '*'))
+					// Jump to the next character that can open, close or break a line.
+					size_t next = findAny(source, current, '/', '*', '\n');
+					column += next - current;
+					current = next;
+					if (isAtEnd()) break;
+
+					if (peek() == '\n')
+					{
+						advance();
+						line++;
+						column = 0;
+						continue;
+					}
+					if ((peek() == '/') && (peekNext() == '*'))
 					{
 						count++;
 						// Skip two characters (combined with advance outside if-else-if block).
 						advance();
+						column++;
 					}
 					else if ((peek() == '*') && (peekNext() == '/'))
 					{
 						count--;
 						advance();
+						column++;
 					}
 					advance(); // Avoids adding an extra advance() in each block.
+					column++;
 				}
 
 				if (count != 0)
@@ -173,8 +537,13 @@ void Scanner::scanToken()
 		case ' ':
 		case '\r':
 		case '\t':
-			// Ignore whitespace.
+		{
+			// Ignore whitespace (the whole run at once).
+			size_t next = skipBlanks(source, current);
+			column += next - current;
+			current = next;
 			break;
+		}
 
 		case '\n':
 			line++;
@@ -196,50 +565,95 @@ void Scanner::scanToken()
 
 void Scanner::identifier()
 {
-	while (isalnum(peek()) || (peek() == '_')) advance();
+	size_t next = skipIdentifier(source, current);
+	column += next - current;
+	current = next;
 
-	std::string text = source.substr(start, current - start);
-	TokenType type = IDENTIFIER;
-	if (keywords.find(text) != keywords.end())
-		type = keywords[text];
-	addToken(type);
-    column += tokens.back().lexeme.size() - 1;
+	addToken(keywordType(source.substr(start, current - start)));
 }
 
+static bool isDecimal(char c)
+{
+    return ((c >= '0') && (c <= '9'));
+}
+
+static bool isHex(char c)
+{
+    return (isDecimal(c) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F')));
+}
+
+static bool isBinary(char c)
+{
+    return ((c == '0') || (c == '1'));
+}
+
+// The value itself is decoded from the lexeme later (see Token::literal),
+// so this only finds where the literal ends and checks its shape.
 void Scanner::number()
 {
-	while (isdigit(peek())) advance();
+	char prefix = peek();
+	if ((source[start] == '0') &&
+		((prefix == 'x') || (prefix == 'X') || (prefix == 'b') || (prefix == 'B')))
+	{
+		// Hexadecimal (0x) or binary (0b) integer.
+		advance();
+		bool (*isDigit)(char) = ((prefix == 'x') || (prefix == 'X')) ? isHex : isBinary;
+		if (!isDigit(peek()))
+			throw ScanError(line, startColumn + (current - start), fileName,
+							"Expect digits after number prefix.");
+		digits(isDigit);
+	}
+	else
+	{
+		digits(isDecimal);
+
+		// Look for a fractional part.
+		if ((peek() == '.') && isdigit(peekNext()))
+		{
+			// Consume the "."
+			advance();
+			digits(isDecimal);
+		}
+	}
 
-	// Look for a fractional part.
-	if ((peek() == '.') && isdigit(peekNext()))
+	addToken(NUMBER);
+    column += current - start - 1;
+}
+
+// A run of digits, which may be grouped with single underscores (1_000).
+void Scanner::digits(bool (*isDigit)(char))
+{
+	while (true)
 	{
-		// Consume the "."
+		while (isDigit(peek())) advance();
+		if (peek() != '_') return;
+		if (!isDigit(peekNext()))
+			throw ScanError(line, startColumn + (current - start), fileName,
+							"Digit separator must be between digits.");
 		advance();
-		while (isdigit(peek())) advance();
 	}
-	Object num(std::stod(source.substr(start, current - start + 1)));
-	addToken(NUMBER, num);
-    column += tokens.back().lexeme.size() - 1;
 }
 
 void Scanner::string()
 {
-	while ((peek() != '"') && !isAtEnd())
+	while (true)
 	{
-		if (peek() == '\n')
-        {
-            line++;
-            column = 0;
-        }
+		size_t next = findAny(source, current, '"', '\n', '"');
+		column += next - current;
+		current = next;
+		if (isAtEnd() || (peek() == '"')) break;
+
+		// A newline inside the string.
 		advance();
+		line++;
+		column = 0;
 	}
 	if (isAtEnd())
 		throw ScanError(line, column, fileName, "Unterminated string.");
 	// The closing ".
 	advance();
+	column++;
 
-	// Trim the surrounding quotes.
-	std::string value = source.substr(start + 1, (current - 1) - (start + 1));
-	addToken(STRING, Object(value));
-    column += tokens.back().lexeme.size() - 1;
+	// The value (without the quotes) is read from the lexeme when needed.
+	addToken(STRING);
 }
\ No newline at end of file
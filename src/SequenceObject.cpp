@@ -0,0 +1,293 @@
+#include "../include/SequenceObject.h"
+#include "../include/Error.h"
+#include "../include/Expr.h"
+#include "../include/Interpreter.h"
+#include "../include/ListObject.h"
+#include "../include/Object.h"
+#include "../include/Token.h"
+#include "../include/Types.h"
+#include <any>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define double(obj) std::any_cast<double>(obj.value)
+#define list(obj) std::any_cast<ListObject>(obj.value)
+#define sequence(obj) std::any_cast<SequenceObject>(obj.value)
+
+struct SequenceMethod
+{
+    std::string_view name;
+    int arity;
+};
+
+static SequenceMethod methods[] = {
+    // Lazy stages.
+    {"transform", 1}, {"filter", 1}, {"pair", 1}, {"flat", 0},
+    // Terminal methods.
+    {"collect", 0}, {"forEach", 1}, {"any", 1}, {"all", 1},
+    {"contains", 1}, {"index", 1}, {"join", 1},
+    {"sum", 0}, {"min", 0}, {"max", 0}, {"average", 0}
+};
+
+// class SequenceObject
+
+SequenceObject::SequenceObject(ListObject source)
+{
+    this->source = source;
+}
+
+SequenceObject SequenceObject::extend(StageKind kind, Object argument, Call* site)
+{
+    SequenceObject extended = *this;
+    extended.stages.push_back({kind, argument, site});
+    return extended;
+}
+
+Object SequenceObject::get(Token name)
+{
+    for (SequenceMethod& method : methods)
+    {
+        if (method.name == name.lexeme)
+            return Object(SequenceFunction(method.name, *this));
+    }
+
+    throw RuntimeError(name, "Undefined property or method '" + std::string(name.lexeme) + "'.");
+}
+
+void SequenceObject::run(Interpreter& interpreter, const std::function<bool(Object)>& sink)
+{
+    // Per-stage cursors (only PAIR uses one), reset for every pass.
+    std::vector<size_t> positions(stages.size(), 0);
+
+    // Index-based so that a callback growing the source list stays safe.
+    for (int i = 0; i < source.size(); i++)
+    {
+        if (!push(interpreter, 0, source[i], positions, sink))
+            return;
+    }
+}
+
+bool SequenceObject::push(Interpreter& interpreter, size_t stage, Object value,
+                          std::vector<size_t>& positions, const std::function<bool(Object)>& sink)
+{
+    for (; stage < stages.size(); stage++)
+    {
+        Stage& current = stages[stage];
+        switch (current.kind)
+        {
+            case TRANSFORM:
+                value = interpreter.invoke(current.argument, {value}, current.site);
+                break;
+            case FILTER:
+                if (!interpreter.isTruthy(interpreter.invoke(current.argument, {value}, current.site)))
+                    return true;
+                break;
+            case PAIR:
+            {
+                ListObject other = list(current.argument);
+                // The shorter side decides the length, so nothing more can come out.
+                if ((int) positions[stage] >= other.size())
+                    return false;
+                value = Object(ListObject({value, other[positions[stage]++]}));
+                break;
+            }
+            case FLAT:
+            {
+                if (type(value) == LIST)
+                {
+                    ListObject inner = list(value);
+                    for (int i = 0; i < inner.size(); i++)
+                    {
+                        if (!push(interpreter, stage + 1, inner[i], positions, sink))
+                            return false;
+                    }
+                    return true;
+                }
+                if (type(value) == SEQ)
+                {
+                    bool keepGoing = true;
+                    sequence(value).run(interpreter, [&](Object inner) {
+                        keepGoing = push(interpreter, stage + 1, inner, positions, sink);
+                        return keepGoing;
+                    });
+                    return keepGoing;
+                }
+                break;
+            }
+        }
+    }
+
+    return sink(value);
+}
+
+ListObject SequenceObject::collect(Interpreter& interpreter)
+{
+    std::vector<Object> elements;
+    run(interpreter, [&](Object value) {
+        elements.push_back(value);
+        return true;
+    });
+    return ListObject(std::move(elements));
+}
+
+std::string SequenceObject::toString(Interpreter& interpreter)
+{
+    return collect(interpreter).toString(interpreter);
+}
+
+bool SequenceObject::hasMethod(std::string_view mode)
+{
+    for (SequenceMethod& method : methods)
+    {
+        if (method.name == mode) return true;
+    }
+    return false;
+}
+
+int SequenceObject::arity(std::string_view mode)
+{
+    for (SequenceMethod& method : methods)
+    {
+        if (method.name == mode) return method.arity;
+    }
+    return -1; // Unreachable.
+}
+
+Object SequenceObject::apply(std::string_view mode, Interpreter& interpreter, Call* expr,
+                             std::vector<Object> arguments)
+{
+    if ((mode == "transform") || (mode == "filter") || (mode == "forEach") ||
+        (mode == "any") || (mode == "all"))
+    {
+        if (!interpreter.isCallable(arguments[0]))
+            throw RuntimeError(expr->paren, "Expected a function argument.");
+    }
+
+    if (mode == "transform")
+        return Object(extend(TRANSFORM, arguments[0], expr));
+    if (mode == "filter")
+        return Object(extend(FILTER, arguments[0], expr));
+    if (mode == "pair")
+    {
+        Object other = arguments[0];
+        // Pairing walks the other side by position, so it has to exist in full.
+        if (type(other) == SEQ)
+            other = Object(sequence(other).collect(interpreter));
+        else if (type(other) != LIST)
+            throw RuntimeError(expr->paren, "Can only pair with a list or sequence.");
+        return Object(extend(PAIR, other, expr));
+    }
+    if (mode == "flat")
+        return Object(extend(FLAT, Object(nullptr), expr));
+
+    if (mode == "collect")
+        return Object(collect(interpreter));
+    if (mode == "forEach")
+    {
+        run(interpreter, [&](Object value) {
+            interpreter.invoke(arguments[0], {value}, expr);
+            return true;
+        });
+        return Object(nullptr);
+    }
+    if ((mode == "any") || (mode == "all"))
+    {
+        // any() stops at the first match, all() at the first miss.
+        bool target = (mode == "any");
+        bool result = !target;
+        run(interpreter, [&](Object value) {
+            if (interpreter.isTruthy(interpreter.invoke(arguments[0], {value}, expr)) == target)
+            {
+                result = target;
+                return false;
+            }
+            return true;
+        });
+        return Object(result);
+    }
+    if ((mode == "contains") || (mode == "index"))
+    {
+        double position = 0;
+        bool found = false;
+        run(interpreter, [&](Object value) {
+            if (interpreter.isEqual(value, arguments[0]))
+            {
+                found = true;
+                return false;
+            }
+            position++;
+            return true;
+        });
+        if (mode == "contains") return Object(found);
+        if (found) return Object(position);
+        return Object(nullptr);
+    }
+    if (mode == "join")
+    {
+        if (type(arguments[0]) != STR)
+            throw RuntimeError(expr->paren, "Separator must be a string.");
+        std::string separator = std::any_cast<std::string>(arguments[0].value);
+        std::string result;
+        bool first = true;
+        run(interpreter, [&](Object value) {
+            if (!first) result += separator;
+            result += interpreter.stringify(value);
+            first = false;
+            return true;
+        });
+        return Object(result);
+    }
+
+    return reduce(mode, interpreter, expr);
+}
+
+Object SequenceObject::reduce(std::string_view mode, Interpreter& interpreter, Call* expr)
+{
+    double total = 0;
+    double count = 0;
+    double best = 0;
+
+    run(interpreter, [&](Object value) {
+        if (type(value) != NUM)
+            throw RuntimeError(expr->paren, "Can only compute " + std::string(mode) +
+                               " of numbers.");
+        double number = double(value);
+        if ((count == 0) || ((mode == "min") && (number < best)) ||
+            ((mode == "max") && (number > best)))
+            best = number;
+        total += number;
+        count++;
+        return true;
+    });
+
+    if (mode == "sum") return Object(total);
+    // The rest have no value for an empty sequence.
+    if (count == 0) return Object(nullptr);
+    if (mode == "average") return Object(total / count);
+    return Object(best);
+}
+
+// class SequenceFunction
+
+SequenceFunction::SequenceFunction(std::string_view mode, SequenceObject instance)
+{
+    this->mode = mode;
+    this->instance = instance;
+}
+
+Object SequenceFunction::call(Interpreter& interpreter, Expr* expr, std::vector<Object> arguments)
+{
+    return instance.apply(mode, interpreter, (Call *) expr, arguments);
+}
+
+int SequenceFunction::arity()
+{
+    return SequenceObject::arity(mode);
+}
+
+std::string SequenceFunction::toString()
+{
+    return "<sequence method " + std::string(mode) + ">";
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "../include/SourceTable.h"
+#include <deque>
+#include <string>
+#include <string_view>
+#if defined(__unix__) || defined(__APPLE__)
+#define MAP_SOURCES
+#include <fcntl.h>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+std::deque<SourceTable::File> SourceTable::files = { {"", "", ""} };
+
+int SourceTable::add(std::string name, std::string text)
+{
+    files.push_back({std::move(name), std::move(text), ""});
+    // Only point at the storage once it has its final place.
+    files.back().text = files.back().storage;
+    return (int) files.size() - 1;
+}
+
+int SourceTable::load(std::string path)
+{
+#ifdef MAP_SOURCES
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor == -1) return -1;
+
+    struct stat info;
+    if ((fstat(descriptor, &info) == 0) && S_ISREG(info.st_mode) &&
+        ((size_t) info.st_size >= mapMinimum))
+    {
+        size_t size = (size_t) info.st_size;
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped != MAP_FAILED)
+        {
+            close(descriptor);
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            files.push_back({std::move(path), "", std::string_view((const char *) mapped, size), true});
+            return (int) files.size() - 1;
+        }
+    }
+
+    // Small files, pipes, or a failed mapping: read everything at once.
+    std::string text;
+    char buffer[1 << 16];
+    ssize_t count;
+    while ((count = read(descriptor, buffer, sizeof(buffer))) > 0)
+        text.append(buffer, (size_t) count);
+    close(descriptor);
+    if (count < 0) return -1;
+#else
+    std::ifstream fileIn(path, std::ios::binary);
+    if (fileIn.fail()) return -1;
+    std::string text((std::istreambuf_iterator<char>(fileIn)), std::istreambuf_iterator<char>());
+#endif
+    return add(std::move(path), std::move(text));
+}
+
+void SourceTable::seal(int file)
+{
+#ifdef MAP_SOURCES
+    File& entry = files[file];
+    if (!entry.mapped) return;
+    entry.mapped = false;
+
+    void* address = (void*) entry.text.data();
+    size_t size = entry.text.size();
+    void* copy = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (copy == MAP_FAILED) return; // Stays mapped.
+    memcpy(copy, address, size);
+    mprotect(copy, size, PROT_READ);
+#ifdef __linux__
+    // Moving the copy onto the mapping unmaps the file's pages.
+    if (mremap(copy, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, address) != MAP_FAILED)
+        return;
+#endif
+    // Otherwise fresh pages replace the file's, and get the copy.
+    if (mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+             -1, 0) != MAP_FAILED)
+    {
+        memcpy(address, copy, size);
+        mprotect(address, size, PROT_READ);
+    }
+    munmap(copy, size);
+#else
+    (void) file;
+#endif
+}
+
+std::string_view SourceTable::text(int file)
+{
+    return files[file].text;
+}
+
+const std::string& SourceTable::name(int file)
+{
+    return files[file].name;
+}
\ No newline at end of file
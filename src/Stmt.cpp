@@ -111,10 +111,11 @@ bool Continue::operator==(Stmt& other)
 }
 
 // Fetch.
-Fetch::Fetch(std::string mode, std::string name)
+Fetch::Fetch(std::string mode, std::string name, Module* module)
 {
     this->name = name;
     this->mode = mode;
+    this->module = module;
 }
 
 void Fetch::accept(Visitor& visitor)
@@ -161,12 +162,14 @@ bool Function::operator==(Stmt& other)
     {
         if (check->params != nullptr) return false;
         return ((this->name == check->name) &&
-                (this->body == check->body));
+                (this->body == check->body) &&
+                (this->lazy == check->lazy));
     }
     if (check->params == nullptr) return false;
     return ((this->name == check->name) &&
             (*(this->params) == *(check->params)) &&
-            (this->body == check->body));
+            (this->body == check->body) &&
+            (this->lazy == check->lazy));
 }
 
 // If.
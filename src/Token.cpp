@@ -1,17 +1,60 @@
-#include "../include/Object.h"
 #include "../include/Token.h"
+#include "../include/Object.h"
+#include "../include/SourceTable.h"
 #include "../include/TokenType.h"
+#include <cctype>
+#include <charconv>
+#include <cmath>
 #include <string>
+#include <string_view>
+#include <system_error>
+
+// Numbers are read straight from the source with std::from_chars (no
+// substr/stod). The Scanner has already checked the shape: decimal with
+// an optional fraction, 0x hexadecimal or 0b binary, and '_' only
+// between digits.
+static double parseNumber(std::string_view text)
+{
+    // Separators are rare, so only then is a stripped copy made.
+    std::string stripped;
+    if (text.find('_') != std::string_view::npos)
+    {
+        for (char c : text)
+        {
+            if (c != '_') stripped += c;
+        }
+        text = stripped;
+    }
+
+    const char* end = text.data() + text.size();
+    if ((text.size() > 2) && (text[0] == '0') && isalpha((unsigned char) text[1]))
+    {
+        int base = (tolower((unsigned char) text[1]) == 'x') ? 16 : 2;
+        unsigned long long integer;
+        if (std::from_chars(text.data() + 2, end, integer, base).ec == std::errc())
+            return (double) integer;
+
+        // Wider than 64 bits: settle for the nearest double.
+        double value = 0;
+        for (char c : text.substr(2))
+            value = value * base + (isdigit((unsigned char) c) ? c - '0' : tolower(c) - 'a' + 10);
+        return value;
+    }
+
+    double value = 0;
+    if (std::from_chars(text.data(), end, value).ec == std::errc::result_out_of_range)
+        return HUGE_VAL;
+    return value;
+}
 
-Token::Token(TokenType type, std::string lexeme, Object literal, int line,
-             int column, std::string fileName)
+Token::Token(TokenType type, std::string_view lexeme, int line, int column,
+             int file)
 {
 	this->type = type;
 	this->lexeme = lexeme;
-	this->literal = literal;
 	this->line = line;
     this->column = column;
-    this->fileName = fileName;
+    this->file = file;
 }
 
 bool Token::operator==(Token& other)
@@ -20,17 +63,32 @@ bool Token::operator==(Token& other)
             (this->lexeme == other.lexeme) &&
             (this->line == other.line) &&
             (this->column == other.column) &&
-            (this->fileName == other.fileName));
+            (this->file == other.file));
+}
+
+Object Token::literal() const
+{
+    if (type == NUMBER)
+        return Object(parseNumber(lexeme));
+    if (type == STRING)
+        // Trim the surrounding quotes.
+        return Object(std::string(lexeme.substr(1, lexeme.size() - 2)));
+    return Object(nullptr);
+}
+
+const std::string& Token::fileName() const
+{
+    return SourceTable::name(file);
 }
 
-std::string Token::toString()
+std::string Token::toString() const
 {
 	if (type != eof)
 	{
 		if ((type == STRING) || (type == NUMBER))
-			return types[type] + " " + lexeme + " " + literal.printVal();
+			return types[type] + " " + std::string(lexeme) + " " + literal().printVal();
 		else
-			return types[type] + " " + lexeme + " null";
+			return types[type] + " " + std::string(lexeme) + " null";
 	}
 	else
 		return "EOF null";
@@ -1,11 +1,14 @@
 #include "../include/Types.h"
+#include "../include/ArrayObject.h"
 #include "../include/BuiltinFunction.h"
 #include "../include/ClassInstance.h"
+#include "../include/DictObject.h"
 #include "../include/ListObject.h"
 #include "../include/LoxClass.h"
 #include "../include/LoxFunction.h"
 #include "../include/LoxInstance.h"
 #include "../include/Object.h"
+#include "../include/SequenceObject.h"
 #include <any>
 #include <string>
 #include <typeinfo>
@@ -32,6 +35,18 @@ Type type(std::any value)
         return LIST;
     if (value.type() == typeid(ListFunction))
         return LIST_FUNC;
+    if (value.type() == typeid(SequenceObject))
+        return SEQ;
+    if (value.type() == typeid(SequenceFunction))
+        return SEQ_FUNC;
+    if (value.type() == typeid(DictObject))
+        return DICT;
+    if (value.type() == typeid(DictFunction))
+        return DICT_FUNC;
+    if (value.type() == typeid(ArrayObject))
+        return ARRAY;
+    if (value.type() == typeid(ArrayFunction))
+        return ARRAY_FUNC;
     if (value.type() == typeid(time_t))
         return TIME;
     if (value.type() == typeid(std::vector<int>))